@@ -0,0 +1,293 @@
+/*
+ * xrick/context.h
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Game context, i.e. the whole mutable state of one game.
+ *
+ * Resources (sprites, tiles, maps...) are read-only once loaded and shared
+ * by all games. Everything a game modifies lives in a game_ctx_t instead,
+ * hence several games can run in one process, each one in its own context.
+ *
+ * The game code still refers to its state through the historical names
+ * (ent_ents, map_map, game_score...) which are defined below as members of
+ * the current context. The current context is per thread: use
+ * game_setContext() to switch between contexts on one thread, or to select
+ * the context a new thread works with.
+ */
+
+#ifndef _CONTEXT_H
+#define _CONTEXT_H
+
+#include "xrick/system/basic_types.h"
+#include "xrick/system/system.h"
+#include "xrick/rects.h"
+#include "xrick/ents.h"
+#include "xrick/maps.h"
+#include "xrick/screens.h"
+#ifdef ENABLE_SOUND
+#include "xrick/data/sounds.h"
+#endif
+
+#include <stddef.h> /* offsetof */
+
+/*
+ * size of the memory stack of a context: marks, high scores and
+ * rectangles allocated while drawing a frame.
+ */
+enum { GAME_CTX_STACK_SIZE = 8*1024 };
+
+/*
+ * game states
+ */
+typedef enum {
+#ifdef ENABLE_DEVTOOLS
+  DEVTOOLS,
+#endif
+  XRICK,
+  INIT_GAME, INIT_BUFFER,
+  INTRO_MAIN, INTRO_MAP,
+  PAUSE_PRESSED1, PAUSE_PRESSED1B, PAUSED, PAUSE_PRESSED2,
+  PLAY0, PLAY1, PLAY2, PLAY3,
+  CHAIN_SUBMAP, CHAIN_MAP, CHAIN_END,
+  SCROLL_UP, SCROLL_DOWN,
+  RESTART, GAMEOVER, GETNAME, EXIT
+} game_state_t;
+
+typedef struct game_ctx_s {
+  /*
+   * game state, i.e. what a snapshot saves: plain values only, and
+   * nothing but them until game_ctx_state_end
+   */
+
+  /* control */
+  unsigned control_status;
+  bool control_active;
+
+  /* draw */
+#ifdef GFXPC
+  U16 draw_filter;
+#endif
+  U8 draw_tilesBank;
+
+  /* entities */
+  ent_t ent_ents[ENT_ENTSNUM + 1];
+#ifdef ENABLE_CHEATS
+  bool ent_ch3;
+#endif
+
+  bool e_bomb_lethal;
+  U8 e_bomb_ticker;
+  U8 e_bomb_xc;
+  U16 e_bomb_yc;
+
+  S8 e_bullet_offsx;
+  S16 e_bullet_xc, e_bullet_yc;
+
+  unsigned e_rick_state;
+  S16 e_rick_stop_x, e_rick_stop_y;
+  struct {
+    U8 scrawl;
+    bool trigger;
+    S8 offsx;
+    U8 ylow;
+    S16 offsy;
+    U8 seq;
+    U8 save_crawl, save_direction;
+    U16 save_x, save_y;
+    U8 stopped;
+  } e_rick;
+
+  bool e_sbonus_counting;
+  U8 e_sbonus_counter;
+  U16 e_sbonus_bonus;
+
+  U32 e_them_rndseed;
+  U16 e_them_rndnbr;
+
+  /* game */
+  U8 game_lives;           /* lives counter */
+  U8 game_bombs;           /* bombs counter */
+  U8 game_bullets;         /* bullets counter */
+  U32 game_score;          /* score */
+  U16 game_map;            /* current map */
+  U16 game_submap;         /* current submap */
+  U8 game_dir;             /* direction (LEFT, RIGHT) */
+  bool game_chsm;          /* change submap request (true, false) */
+  bool game_waitevt;       /* wait for events (true, false) */
+  U8 game_period;          /* time between each frame, in millisecond */
+  U32 game_time;           /* game time i.e. sum of all frame periods, in millisecond */
+  bool game_cheat1;        /* infinite lives, bombs and bullets */
+  bool game_cheat2;        /* never die */
+  bool game_cheat3;        /* highlight sprites */
+  game_state_t game_state;
+  U8 game_isave_frow;
+  int game_startMap;       /* map new games start at */
+  int game_startSubmap;    /* submap new games start at, 0 for first of map */
+
+  /* maps */
+  U8 map_map[MAP_RING_ROWS][0x20];  /* ring of rows, see map_map() below */
+  U8 map_rowBase;          /* ring row of map_map row 0 */
+  U32 map_fgnd[MAP_RING_ROWS];  /* foreground columns of each row, see map_fgnd() below */
+  U8 map_eflg[0x100];
+  U8 map_frow;
+  U8 map_tilesBank;
+
+  /* screens */
+  struct {
+    U8 seq;
+    U8 period;
+    U32 tm;
+  } gameover;
+  struct {
+    U8 seq;
+    U8 x, y, p;
+    U8 player_name[HISCORE_NAME_SIZE];
+    U32 tm;
+  } getname;
+  struct {
+    U8 seq;
+    U8 seen;
+    bool first;
+    U8 period;
+    U32 tm;
+  } imain;
+  struct {
+    U16 step;
+    U16 loops;
+    U16 run;
+    U8 flipflop;
+    U8 spnum;
+    U16 spx, spdx;
+    U16 spy, spdy;
+    U16 spbase, spoffs;
+    U8 seq;
+  } imap;
+  struct {
+    U8 seq;
+    U8 wait;
+  } xrick;
+
+  /* scroller */
+  struct {
+    U8 period;
+    U8 upPhase;
+    U8 downPhase;
+  } scroll;
+
+  /*
+   * end of game state: below are pointers, and what only lasts one frame
+   */
+  U8 game_ctx_state_end;
+
+  U8 *framebuffer;        /* frame buffer the game draws into */
+  U8 *draw_tllst;
+  rect_t draw_STATUSRECT;
+  U8 *draw_fb;            /* current position in frame buffer */
+  U32 draw_shadow[0x18][0x20];   /* map tiles in frame buffer, see draw.c */
+  rect_t draw_mapRects[0x18];    /* rows redrawn by draw_map */
+  struct {
+    U32 cells[0x20];  /* status bar tiles in frame buffer, see draw.c */
+    U32 score;        /* score the digits are for */
+    U8 digits[6];     /* score digit tiles */
+    S8 first, last;   /* cells drawn since draw_STATUSRECT was last set */
+  } draw_status;
+  rect_t *ent_rects;
+  const rect_t *game_rects;  /* rectangles to redraw at each frame */
+  bool game_skipDraw;     /* frame will not be presented, do not draw entities */
+  bool game_drawPending;  /* entities have not been drawn since they last moved */
+#ifdef ENABLE_SOUND
+  sound_t *game_currentMusic;
+#endif
+  mark_t *map_marks;      /* copy of map_marks_init */
+  hiscore_t *screen_highScores;  /* copy of screen_highScores_init */
+
+  /* memory */
+  sysmem_stack_t stack;
+  sysmem_mark_t frameMark;  /* what a frame allocates goes above, see game_step */
+  U8 stackBuffer[GAME_CTX_STACK_SIZE];
+} game_ctx_t;
+
+/* size of the game state at the beginning of a context */
+#define GAME_CTX_STATE_SIZE offsetof(game_ctx_t, game_ctx_state_end)
+
+extern THREAD_LOCAL game_ctx_t *game_ctx;  /* current context */
+
+/*
+ * state of the current context
+ */
+#define control_status (game_ctx->control_status)
+#define control_active (game_ctx->control_active)
+
+#define draw_tllst (game_ctx->draw_tllst)
+#ifdef GFXPC
+#define draw_filter (game_ctx->draw_filter)
+#endif
+#define draw_tilesBank (game_ctx->draw_tilesBank)
+#define draw_STATUSRECT (game_ctx->draw_STATUSRECT)
+
+#define ent_ents (game_ctx->ent_ents)
+#define ent_rects (game_ctx->ent_rects)
+
+#define e_bomb_lethal (game_ctx->e_bomb_lethal)
+#define e_bomb_ticker (game_ctx->e_bomb_ticker)
+#define e_bomb_xc (game_ctx->e_bomb_xc)
+#define e_bomb_yc (game_ctx->e_bomb_yc)
+
+#define e_bullet_offsx (game_ctx->e_bullet_offsx)
+#define e_bullet_xc (game_ctx->e_bullet_xc)
+#define e_bullet_yc (game_ctx->e_bullet_yc)
+
+#define e_rick_state (game_ctx->e_rick_state)
+#define e_rick_stop_x (game_ctx->e_rick_stop_x)
+#define e_rick_stop_y (game_ctx->e_rick_stop_y)
+
+#define e_sbonus_counting (game_ctx->e_sbonus_counting)
+#define e_sbonus_counter (game_ctx->e_sbonus_counter)
+#define e_sbonus_bonus (game_ctx->e_sbonus_bonus)
+
+#define e_them_rndseed (game_ctx->e_them_rndseed)
+
+#define game_lives (game_ctx->game_lives)
+#define game_bombs (game_ctx->game_bombs)
+#define game_bullets (game_ctx->game_bullets)
+#define game_score (game_ctx->game_score)
+#define game_map (game_ctx->game_map)
+#define game_submap (game_ctx->game_submap)
+#define game_dir (game_ctx->game_dir)
+#define game_chsm (game_ctx->game_chsm)
+#define game_waitevt (game_ctx->game_waitevt)
+#define game_period (game_ctx->game_period)
+#define game_time (game_ctx->game_time)
+#define game_rects (game_ctx->game_rects)
+#define game_skipDraw (game_ctx->game_skipDraw)
+#define game_cheat1 (game_ctx->game_cheat1)
+#define game_cheat2 (game_ctx->game_cheat2)
+#define game_cheat3 (game_ctx->game_cheat3)
+
+#define map_map(row) (game_ctx->map_map[(map_rowBase + (row)) & (MAP_RING_ROWS - 1)])
+#define map_rowBase (game_ctx->map_rowBase)
+#define map_fgnd(row) (game_ctx->map_fgnd[(map_rowBase + (row)) & (MAP_RING_ROWS - 1)])
+#define map_eflg (game_ctx->map_eflg)
+#define map_frow (game_ctx->map_frow)
+#define map_tilesBank (game_ctx->map_tilesBank)
+#define map_marks (game_ctx->map_marks)
+
+#define screen_highScores (game_ctx->screen_highScores)
+
+#endif /* ndef _CONTEXT_H */
+
+/* eof */
@@ -15,11 +15,10 @@
 
 #include "xrick/control.h"
 
-unsigned control_status = 0;
+/* control_status, control_active: see context.h */
 extern inline bool control_test(control_t c);
 extern inline void control_set(control_t c);
 extern inline void control_clear(control_t c);
-bool control_active = true;
 
 /* eof */
 
@@ -17,6 +17,7 @@
 #define _CONTROL_H
 
 #include "xrick/system/basic_types.h"
+#include "xrick/context.h"
 
 typedef enum
 {
@@ -30,11 +31,9 @@ typedef enum
     Control_FIRE = (1 << 7)
 } control_t;
 
-extern unsigned control_status;
 inline bool control_test(control_t c) { return control_status & c; }
 inline void control_set(control_t c) { control_status |= c; }
 inline void control_clear(control_t c) { control_status &= ~c; }
-extern bool control_active;
 
 #endif /* ndef _CONTROL_H */
 
@@ -18,6 +18,7 @@
  */
 size_t sprites_nbr_sprites = 0;
 sprite_t *sprites_data = NULL;
+sprite_pixels_t *sprites_pixels = NULL;
 
 /* eof */
 
@@ -65,6 +65,30 @@ typedef U32 sprite_t[SPRITES_NBR_DATA];
 extern size_t sprites_nbr_sprites;
 extern sprite_t *sprites_data;
 
+/*
+ * sprites expanded to 8 bits per pixel at load time, for draw_sprite and
+ * draw_sprite2, one line of pixels per sprite row: drawing a line is a
+ * masked copy, f[k] = (f[k] & mask[k]) | pict[k].
+ *
+ * For GFXPC, each line starts with SPRITES_NBR_PAD transparent pixels so
+ * that a sprite shifted right by 0 to 7 pixels within a tile column is
+ * read from the same line, at an offset.
+ */
+#ifdef GFXPC
+enum { SPRITES_NBR_PAD = 8 };
+#endif
+#ifdef GFXST
+enum { SPRITES_NBR_PAD = 0 };
+#endif
+enum { SPRITES_NBR_PIXELS = SPRITES_NBR_PAD + SPRITES_NBR_COLS * 8 };  /* per line */
+
+typedef struct {
+  U8 mask[SPRITES_NBR_ROWS][SPRITES_NBR_PIXELS];
+  U8 pict[SPRITES_NBR_ROWS][SPRITES_NBR_PIXELS];
+} sprite_pixels_t;
+
+extern sprite_pixels_t *sprites_pixels;
+
 #endif /* ndef _SPRITES_H_ */
 
 /* eof */
@@ -18,5 +18,10 @@
  */
 size_t tiles_nbr_banks = 0;
 tile_t *tiles_data = NULL;
+tile_pixels_t *tiles_pixels = NULL;
+
+#ifdef GFXPC
+const U16 tiles_filters[TILES_NBR_FILTERS] = { 0xffff, 0xaaaa, 0x5555 };
+#endif
 
 /* eof */
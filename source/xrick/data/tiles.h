@@ -65,6 +65,22 @@ enum { TILES_NBR_TILES = 0x100 };
 extern size_t tiles_nbr_banks;
 extern tile_t *tiles_data;
 
+/*
+ * tiles expanded to 8 bits per pixel at load time, for draw_tile
+ *
+ * For GFXPC, there is one full set of banks per CGA colors filter
+ * in tiles_filters, the other filters are applied on the fly.
+ */
+enum { TILES_NBR_PIXELS = 0x08 };  /* per line */
+typedef U8 tile_pixels_t[TILES_NBR_LINES][TILES_NBR_PIXELS];
+
+#ifdef GFXPC
+enum { TILES_NBR_FILTERS = 3 };
+extern const U16 tiles_filters[TILES_NBR_FILTERS];
+#endif
+
+extern tile_pixels_t *tiles_pixels;
+
 #endif /* ndef _TILES_H */
 
 /* eof */
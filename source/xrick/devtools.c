@@ -40,7 +40,7 @@ devtools_run(void)
   U8 s[128];
 
   if (seq == 0) {
-    sysvid_clear();
+    draw_clear();
     game_rects = &draw_SCREENRECT;
 #ifdef GFXPC
     draw_filter = 0xffff;
@@ -50,7 +50,7 @@ devtools_run(void)
 
   switch (seq) {
   case 1:  /* draw tiles */
-    sysvid_clear();
+    draw_clear();
     draw_tilesBank = 0;
     sys_snprintf(s, sizeof(s), "TILES@BANK@%d\376", pos);
     draw_setfb(4, 4);
@@ -99,7 +99,7 @@ devtools_run(void)
     }
     break;
   case 21:  /* draw sprites */
-    sysvid_clear();
+    draw_clear();
     draw_tilesBank = 0;
     sys_snprintf(s, sizeof(s), "SPRITES\376");
     draw_setfb(4, 4);
@@ -158,7 +158,7 @@ devtools_run(void)
     }
     break;
   case 40:
-    sysvid_clear();
+    draw_clear();
 #ifdef GFXPC
     if (pos2 == 0) pos2 = 2;
 #endif
@@ -234,7 +234,7 @@ devtools_run(void)
     return SCREEN_EXIT;
 
   if (seq == 99) {  /* we're done */
-    sysvid_clear();
+    draw_clear();
     seq = 0;
     return SCREEN_DONE;
   }
@@ -43,6 +43,19 @@
  * Coordinates can be expressed in pixels. When relative to the map or the
  * map screen, they can also be expressed in tiles, the map being composed
  * of rows of 0x20 tiles of 0x08 by 0x08 pixels.
+ *
+ * draw_map only redraws the map screen tiles which changed since it last
+ * drew them: draw_shadow remembers, for each tile of the map screen, what
+ * is in the frame buffer (tile number, bank and filter), or DRAW_SHADOW_DIRTY
+ * when something else has been drawn over it. Anything drawing onto the
+ * map screen must therefore either mark the tiles it covers (see
+ * draw_dirty) or invalidate the whole shadow (see draw_invalidate).
+ *
+ * The status bar works the same way: draw_status.cells remembers the tiles
+ * of the status bar cells, so that only the indicators which changed are
+ * drawn, and draw_STATUSRECT only covers them. With PC graphics the status
+ * bar lies over the map screen, hence whatever draws the map or sprites
+ * marks the status bar cells it covers too (see draw_statusDirty).
  */
 
 #include "xrick/system/system.h"
@@ -56,6 +69,9 @@
 #include "xrick/maps.h"
 #include "xrick/rects.h"
 #include "xrick/data/img.h"
+#include "xrick/unpack.h"
+
+#include <string.h> /* memset, memcpy */
 
 
 /*
@@ -74,22 +90,48 @@
 #define DRAW_STATUS_Y 0
 #endif
 
+/*
+ * status bar cells (tiles), from the score to the end of the lives
+ */
+#define DRAW_STATUS_CELL(x) (((x) - DRAW_STATUS_SCORE_X) / 8)
+#define DRAW_STATUS_CELLS DRAW_STATUS_CELL(DRAW_STATUS_LIVES_X + 6 * 8)
 
 /*
- * public vars
+ * map screen tiles position (pixels, screen) and size (tiles)
  */
-U8 *draw_tllst;    /* pointer to tiles list */
+#define DRAW_MAP_X (-DRAW_XYMAP_SCRLEFT)
 #ifdef GFXPC
-U16 draw_filter;   /* CGA colors filter */
+#define DRAW_MAP_Y 0
+#endif
+#ifdef GFXST
+#define DRAW_MAP_Y 8
+#endif
+#define DRAW_MAP_ROWS 0x18
+#define DRAW_MAP_COLS 0x20
+
+/* shadow value of a tile that needs to be redrawn */
+#define DRAW_SHADOW_DIRTY 0xffffffff
+
+/* shadow value of a tile drawn with the current bank and filter */
+#ifdef GFXPC
+#define DRAW_SHADOW(t) (((U32)draw_filter << 16) | ((U32)draw_tilesBank << 8) | (t))
+#endif
+#ifdef GFXST
+#define DRAW_SHADOW(t) (((U32)draw_tilesBank << 8) | (t))
 #endif
-U8 draw_tilesBank; /* tile number offset */
 
-rect_t draw_STATUSRECT = {
-  DRAW_STATUS_SCORE_X, DRAW_STATUS_Y,
-  DRAW_STATUS_LIVES_X + 6 * 8 - DRAW_STATUS_SCORE_X, 8,
-  NULL
-};
+
+/*
+ * public vars
+ */
+/*
+ * draw_tllst: pointer to tiles list, see context.h
+ * draw_filter: CGA colors filter, see context.h
+ * draw_tilesBank: tile number offset, see context.h
+ * draw_STATUSRECT: see context.h, initialised by draw_initContext
+ */
 const rect_t draw_SCREENRECT = { 0, 0, SYSVID_WIDTH, SYSVID_HEIGHT, NULL };
+const rect_t draw_MAPRECT = { DRAW_MAP_X, 0, DRAW_MAP_COLS * 8, DRAW_MAP_Y + DRAW_MAP_ROWS * 8, NULL };
 
 size_t game_color_count = 0;
 img_color_t *game_colors = NULL;
@@ -97,7 +139,109 @@ img_color_t *game_colors = NULL;
 /*
  * private vars
  */
-static U8 *fb;     /* frame buffer pointer */
+#define fb (game_ctx->draw_fb)     /* frame buffer pointer */
+#define shadow (game_ctx->draw_shadow)  /* map screen tiles in frame buffer */
+#define status (game_ctx->draw_status)  /* status bar tiles in frame buffer */
+
+
+/*
+ * Initialise the drawing state of the current context
+ *
+ * buffer: frame buffer to draw into
+ */
+void
+draw_initContext(U8 *buffer)
+{
+  game_ctx->framebuffer = buffer;
+  fb = buffer;
+  draw_STATUSRECT.x = DRAW_STATUS_SCORE_X;
+  draw_STATUSRECT.y = DRAW_STATUS_Y;
+  draw_STATUSRECT.width = DRAW_STATUS_LIVES_X + 6 * 8 - DRAW_STATUS_SCORE_X;
+  draw_STATUSRECT.height = 8;
+  draw_STATUSRECT.next = NULL;
+  status.score = 0xffffffff;
+  status.first = status.last = -1;
+  draw_invalidate();
+}
+
+
+/*
+ * Forget what draw_map drew: its next call redraws the whole map screen
+ */
+void
+draw_invalidate(void)
+{
+  memset(shadow, 0xff, sizeof(shadow));
+  memset(status.cells, 0xff, sizeof(status.cells));
+}
+
+
+/*
+ * Mark the status bar cells under a rectangle for redraw
+ *
+ * x, y, width, height: rectangle (pixels, screen)
+ */
+static void
+draw_statusDirty(S16 x, S16 y, U16 width, U16 height)
+{
+  S16 c, c0, c1;
+
+  if (y >= DRAW_STATUS_Y + 8 || y + height <= DRAW_STATUS_Y)
+    return;
+
+  c0 = x - DRAW_STATUS_SCORE_X;
+  c1 = c0 + width - 1;
+  if (c1 < 0) return;
+
+  c0 = (c0 < 0) ? 0 : c0 >> 3;
+  c1 >>= 3;
+  if (c1 >= DRAW_STATUS_CELLS) c1 = DRAW_STATUS_CELLS - 1;
+
+  for (c = c0; c <= c1; c++)
+    status.cells[c] = DRAW_SHADOW_DIRTY;
+}
+
+
+/*
+ * Mark the map screen tiles under a rectangle for redraw
+ *
+ * x, y, width, height: rectangle (pixels, screen)
+ */
+static void
+draw_dirty(S16 x, S16 y, U16 width, U16 height)
+{
+  S16 r, r0, r1, c, c0, c1;
+
+  draw_statusDirty(x, y, width, height);
+
+  r0 = y - DRAW_MAP_Y;
+  r1 = r0 + height - 1;
+  c0 = x - DRAW_MAP_X;
+  c1 = c0 + width - 1;
+  if (r1 < 0 || c1 < 0) return;
+
+  r0 = (r0 < 0) ? 0 : r0 >> 3;
+  r1 >>= 3;
+  c0 = (c0 < 0) ? 0 : c0 >> 3;
+  c1 >>= 3;
+  if (r1 >= DRAW_MAP_ROWS) r1 = DRAW_MAP_ROWS - 1;
+  if (c1 >= DRAW_MAP_COLS) c1 = DRAW_MAP_COLS - 1;
+
+  for (r = r0; r <= r1; r++)
+    for (c = c0; c <= c1; c++)
+      shadow[r][c] = DRAW_SHADOW_DIRTY;
+}
+
+
+/*
+ * Clear the frame buffer
+ */
+void
+draw_clear(void)
+{
+  memset(game_ctx->framebuffer, 0, SYSVID_WIDTH * SYSVID_HEIGHT);
+  draw_invalidate();
+}
 
 
 /*
@@ -108,7 +252,7 @@ static U8 *fb;     /* frame buffer pointer */
 void
 draw_setfb(U16 x, U16 y)
 {
-  fb = sysvid_fb + x + y * SYSVID_WIDTH;
+  fb = game_ctx->framebuffer + x + y * SYSVID_WIDTH;
 }
 
 
@@ -217,6 +361,45 @@ draw_tilesSubList()
 }
 
 
+/*
+ * Copy a tile onto the frame buffer
+ *
+ * f: where to draw the tile
+ * tileNumber: tile number
+ * draw_filter: CGA colors filter
+ */
+static void
+draw_tileAt(U8 *f, U8 tileNumber)
+{
+  U8 i;
+  size_t tile;
+
+  tile = draw_tilesBank * TILES_NBR_TILES + tileNumber;
+
+#ifdef GFXPC
+  for (i = 0; i < TILES_NBR_FILTERS && tiles_filters[i] != draw_filter; i++);
+  if (i == TILES_NBR_FILTERS) {
+    /* filter not pre-expanded */
+    for (i = 0; i < TILES_NBR_LINES; i++) {  /* for all 8 pixel lines */
+      unpack_crumbs(f, &tiles_data[tile][i], 1, draw_filter);
+      f += SYSVID_WIDTH;  /* next line */
+    }
+    return;
+  }
+  tile += i * tiles_nbr_banks * TILES_NBR_TILES;
+#endif
+
+  /*
+   * tiles have been expanded to 8 bits per pixel at load time
+   * (see resources.c): copy them line by line
+   */
+  for (i = 0; i < TILES_NBR_LINES; i++) {  /* for all 8 pixel lines */
+    memcpy(f, tiles_pixels[tile][i], TILES_NBR_PIXELS);
+    f += SYSVID_WIDTH;  /* next line */
+  }
+}
+
+
 /*
  * Draw a tile
  * at position indicated by fb ; leave fb pointing to the next tile
@@ -230,46 +413,29 @@ draw_tilesSubList()
 void
 draw_tile(U8 tileNumber)
 {
-  U8 i, k, *f;
+  size_t offset = fb - game_ctx->framebuffer;
 
-#ifdef GFXPC
-  U16 x;
-#endif
-
-#ifdef GFXST
-  U32 x;
-#endif
-
-  f = fb;  /* frame buffer */
-  for (i = 0; i < TILES_NBR_LINES; i++) {  /* for all 8 pixel lines */
-
-#ifdef GFXPC
-    x = tiles_data[draw_tilesBank * TILES_NBR_TILES + tileNumber][i] & draw_filter;
-    /*
-     * tiles / perform the transformation from CGA 2 bits
-     * per pixel to frame buffer 8 bits per pixels
-     */
-    for (k = 8; k--; x >>= 2)
-      f[k] = x & 3;
-    f += SYSVID_WIDTH;  /* next line */
-#endif
-
-#ifdef GFXST
-  x = tiles_data[draw_tilesBank * TILES_NBR_TILES + tileNumber][i];
-  /*
-   * tiles / perform the transformation from ST 4 bits
-   * per pixel to frame buffer 8 bits per pixels
-   */
-  for (k = 8; k--; x >>= 4)
-    f[k] = x & 0x0F;
-  f += SYSVID_WIDTH;  /* next line */
-#endif
+  draw_dirty(offset % SYSVID_WIDTH, offset / SYSVID_WIDTH, 8, 8);
+  draw_tileAt(fb, tileNumber);
+  fb += 8;  /* next tile */
+}
 
-  }
+/*
+ * Copy a line of sprite pixels onto the frame buffer, through the mask
+ *
+ * This is the innermost loop of sprite drawing: keep it simple enough
+ * for the compiler to vectorize it.
+ */
+static void
+draw_maskedCopy(U8 *f, const U8 *pict, const U8 *mask, U16 n)
+{
+  U16 k;
 
-  fb += 8;  /* next tile */
+  for (k = 0; k < n; k++)
+    f[k] = (f[k] & mask[k]) | pict[k];
 }
 
+
 /*
  * Draw a sprite
  *
@@ -282,26 +448,19 @@ draw_tile(U8 tileNumber)
 void
 draw_sprite(U8 nbr, U16 x, U16 y)
 {
-    U8 i, j, k, *f;
-    U16 xm = 0, xp = 0;
+    const sprite_pixels_t *sprite = &sprites_pixels[nbr];
+    U8 j, *f;
 
     draw_setfb(x, y);
+    draw_dirty(x, y, SPRITES_NBR_COLS * 8, SPRITES_NBR_ROWS);
 
-    for (i = 0; i < SPRITES_NBR_COLS; i++) {  /* for each tile column */
-        f = fb;  /* frame buffer */
-        for (j = 0; j < SPRITES_NBR_ROWS; j++) {  /* for each pixel row */
-            xm = sprites_data[nbr][i][j].mask;  /* mask */
-            xp = sprites_data[nbr][i][j].pict;  /* picture */
-            /*
-            * sprites / perform the transformation from CGA 2 bits
-            * per pixel to frame buffer 8 bits per pixels
-            */
-            for (k = 8; k--; xm >>= 2, xp >>= 2)
-                f[k] = (f[k] & (xm & 3)) | (xp & 3);
-            f += SYSVID_WIDTH;
-        }
-        fb += 8;
+    f = fb;  /* frame buffer */
+    for (j = 0; j < SPRITES_NBR_ROWS; j++) {  /* for each pixel row */
+        draw_maskedCopy(f, sprite->pict[j] + SPRITES_NBR_PAD,
+                        sprite->mask[j] + SPRITES_NBR_PAD, SPRITES_NBR_COLS * 8);
+        f += SYSVID_WIDTH;
     }
+    fb += SPRITES_NBR_COLS * 8;
 }
 #endif
 
@@ -315,20 +474,13 @@ draw_sprite(U8 nbr, U16 x, U16 y)
 void
 draw_sprite(U8 number, U16 x, U16 y)
 {
-    U8 i, j, k, *f;
-    U16 g;
-    U32 d;
+    const sprite_pixels_t *sprite = &sprites_pixels[number];
+    U8 i;
 
     draw_setfb(x, y);
-    g = 0;
+    draw_dirty(x, y, SPRITES_NBR_COLS * 8, SPRITES_NBR_ROWS);
     for (i = 0; i < SPRITES_NBR_ROWS; i++) { /* rows */
-        f = fb;
-        for (j = 0; j < SPRITES_NBR_COLS; j++) { /* cols */
-            d = sprites_data[number][g++];
-            for (k = 8; k--; d >>= 4)
-                if (d & 0x0F) f[k] = (f[k] & 0xF0) | (d & 0x0F);
-            f += 8;
-        }
+        draw_maskedCopy(fb, sprite->pict[i], sprite->mask[i], SPRITES_NBR_COLS * 8);
         fb += SYSVID_WIDTH;
     }
 }
@@ -338,20 +490,29 @@ draw_sprite(U8 number, U16 x, U16 y)
 /*
  * Draw a sprite
  *
- * NOTE re-using original ST graphics format
+ * Clipping is done once: it gives the range of rows to draw, and the
+ * columns [0, w) of each. Each row is then drawn span by span, a span
+ * being a run of the map tile columns the sprite covers which are not
+ * hidden behind the foreground (see map_fgnd). Rows crossing no foreground
+ * tile are drawn as one span, with a fixed width copy when the sprite is
+ * not clipped horizontally.
+ *
+ * NOTE clipping does not skip the clipped pixels of the sprite: at the top
+ * and left borders, the sprite is drawn from its first row and column.
  */
 #ifdef GFXST
 void
 draw_sprite2(U8 number, U16 x, U16 y, bool front)
 {
-  U32 d = 0;   /* sprite data */
+  const sprite_pixels_t *sprite = &sprites_pixels[number];
   S16 x0, y0;  /* clipped x, y */
   U16 w, h;    /* width, height */
-  S16 g,       /* sprite data offset*/
+  S16 g,       /* sprite row */
     r, c,      /* row, column */
-    i,         /* frame buffer shifter */
-    im;        /* tile flag shifter */
-  U8 flg;      /* tile flag */
+    ce;        /* end of span column */
+  U16 col0, col1;  /* first and last map tile columns */
+  U32 cols,    /* map tile columns covered by the sprite */
+    fgnd;      /* foreground tile columns of the row, within cols */
 
   x0 = x;
   y0 = y;
@@ -361,51 +522,50 @@ draw_sprite2(U8 number, U16 x, U16 y, bool front)
   if (draw_clipms(&x0, &y0, &w, &h))  /* return if not visible */
     return;
 
-  g = 0;
   draw_setfb(x0 - DRAW_XYMAP_SCRLEFT, y0 - DRAW_XYMAP_SCRTOP + 8);
+  draw_dirty(x0 - DRAW_XYMAP_SCRLEFT, y0 - DRAW_XYMAP_SCRTOP + 8, w, h);
+  if (w == 0)
+    return;
 
-  for (r = 0; r < SPRITES_NBR_ROWS; r++) {
-    if (r >= h || y + r < y0) continue;
+  /* tile columns the foreground can hide, none if beyond the map */
+  col0 = x >> 3;
+  col1 = (x + w - 1) >> 3;
+  cols = (col0 < 0x20) ? (0xffffffff >> (31 - col1)) & (0xffffffff << col0) : 0;
+#ifdef ENABLE_CHEATS
+  if (front || game_cheat3) cols = 0;
+#else
+  if (front) cols = 0;
+#endif
 
-    i = 0x1f;
-    im = x - (x & 0xfff8);
-    flg = map_eflg[map_map[(y + r) >> 3][(x + 0x1f)>> 3]];
+  for (r = y0 - y, g = 0; r < (S16)h; r++, g++) {
+    fgnd = map_fgnd((y + r) >> 3) & cols;
 
-#ifdef ENABLE_CHEATS
-#define LOOP(N, C0, C1) \
-    d = sprites_data[number][g + N]; \
-    for (c = C0; c >= C1; c--, i--, d >>= 4, im--) { \
-      if (im == 0) { \
-    flg = map_eflg[map_map[(y + r) >> 3][(x + c) >> 3]]; \
-    im = 8; \
-      } \
-      if (c >= w || x + c < x0) continue; \
-      if (!front && !game_cheat3 && (flg & MAP_EFLG_FGND)) continue; \
-      if (d & 0x0F) fb[i] = (fb[i] & 0xF0) | (d & 0x0F); \
-      if (game_cheat3) fb[i] |= 0x10; \
+    if (!fgnd) {  /* one span */
+      if (w == SPRITES_NBR_COLS * 8)
+        draw_maskedCopy(fb, sprite->pict[g], sprite->mask[g], SPRITES_NBR_COLS * 8);
+      else
+        draw_maskedCopy(fb, sprite->pict[g], sprite->mask[g], w);
     }
-#else
-#define LOOP(N, C0, C1) \
-    d = sprites_data[number][g + N]; \
-    for (c = C0; c >= C1; c--, i--, d >>= 4, im--) { \
-      if (im == 0) { \
-    flg = map_eflg[map_map[(y + r) >> 3][(x + c) >> 3]]; \
-    im = 8; \
-      } \
-      if (!front && (flg & MAP_EFLG_FGND)) continue; \
-      if (c >= w || x + c < x0) continue; \
-      if (d & 0x0F) fb[i] = (fb[i] & 0xF0) | (d & 0x0F); \
+    else {
+      for (c = 0; c < w; c = ce) {  /* for each span */
+        ce = c + 8 - ((x + c) & 7);
+        if ((fgnd >> ((x + c) >> 3)) & 1)
+          continue;  /* hidden */
+        while (ce < w && !((fgnd >> ((x + ce) >> 3)) & 1))
+          ce += 8;  /* next tile column is visible too */
+        if (ce > w) ce = w;
+        draw_maskedCopy(fb + c, sprite->pict[g] + c, sprite->mask[g] + c, ce - c);
+      }
+    }
+#ifdef ENABLE_CHEATS
+    if (game_cheat3) {
+      /* cols is 0: the row is one span */
+      for (c = 0; c < w; c++)
+        fb[c] |= 0x10;
     }
 #endif
-    LOOP(3, 0x1f, 0x18);
-    LOOP(2, 0x17, 0x10);
-    LOOP(1, 0x0f, 0x08);
-    LOOP(0, 0x07, 0x00);
-
-#undef LOOP
 
     fb += SYSVID_WIDTH;
-    g += SPRITES_NBR_COLS;
   }
 }
 
@@ -416,6 +576,9 @@ draw_sprite2(U8 number, U16 x, U16 y, bool front)
  * Draw a sprite
  * align to tile column, determine plane automatically, and clip
  *
+ * Each row is drawn span by span, a span being a run of tile columns
+ * which are not hidden behind the foreground.
+ *
  * nbr: sprite number
  * x, y: sprite position (pixels, map).
  * fb: CHANGED
@@ -424,65 +587,59 @@ draw_sprite2(U8 number, U16 x, U16 y, bool front)
 void
 draw_sprite2(U8 number, U16 x, U16 y, bool front)
 {
-  U8 k, *f, c, r, dx;
+  const sprite_pixels_t *sprite = &sprites_pixels[number];
+  U8 *f, c, ce, r, dx;
   U16 cmax, rmax;
-  U16 xm = 0, xp = 0;
   S16 xmap, ymap;
+  U32 fgnd;  /* foreground tile columns of the row, from the first one drawn */
 
   /* align to tile column, prepare map coordinate and clip */
   xmap = x & 0xFFF8;
   ymap = y;
   cmax = SPRITES_NBR_COLS * 8;  /* width, 4 tile columns, 8 pixels each */
   rmax = SPRITES_NBR_ROWS;  /* height, 15 pixels */
-  dx = (x - xmap) * 2;
+  dx = x - xmap;  /* shift within tile column, pixels */
   if (draw_clipms(&xmap, &ymap, &cmax, &rmax))  /* return if not visible */
     return;
 
   /* get back to screen */
   draw_setfb(xmap - DRAW_XYMAP_SCRLEFT, ymap - DRAW_XYMAP_SCRTOP);
+  draw_dirty(xmap - DRAW_XYMAP_SCRLEFT, ymap - DRAW_XYMAP_SCRTOP, cmax, rmax);
+  if (cmax == 0)  /* right at the edge, clipped out: xmap >> 3 would be 32 */
+    return;
   xmap >>= 3;
   cmax >>= 3;
 
   /* draw */
-  for (c = 0; c < cmax; c++) {  /* for each tile column */
-    f = fb;
-    for (r = 0; r < rmax; r++) {  /* for each pixel row */
-      /* check that tile is not hidden behind foreground */
+  f = fb;
+  for (r = 0; r < rmax; r++) {  /* for each pixel row */
+    const U8 *pict = sprite->pict[r] + SPRITES_NBR_PAD - dx;
+    const U8 *mask = sprite->mask[r] + SPRITES_NBR_PAD - dx;
+
 #ifdef ENABLE_CHEATS
-      if (front || game_cheat3 ||
-      !(map_eflg[map_map[(ymap + r) >> 3][xmap + c]] & MAP_EFLG_FGND)) {
+    fgnd = (front || game_cheat3) ? 0 : map_fgnd((ymap + r) >> 3) >> xmap;
 #else
-      if (front ||
-      !(map_eflg[map_map[(ymap + r) >> 3][xmap + c]] & MAP_EFLG_FGND)) {
+    fgnd = front ? 0 : map_fgnd((ymap + r) >> 3) >> xmap;
 #endif
-    xp = xm = 0;
-    if (c > 0) {
-      xm |= sprites_data[number][c - 1][r].mask << (16 - dx);
-      xp |= sprites_data[number][c - 1][r].pict << (16 - dx);
-    }
-    else
-      xm |= 0xFFFF << (16 - dx);
-    if (c < cmax) {
-      xm |= sprites_data[number][c][r].mask >> dx;
-      xp |= sprites_data[number][c][r].pict >> dx;
-    }
-    else
-      xm |= 0xFFFF >> dx;
-    /*
-     * sprites / perform the transformation from CGA 2 bits
-     * per pixel to frame buffer 8 bits per pixels
-     */
-    for (k = 8; k--; xm >>= 2, xp >>= 2) {
-      f[k] = ((f[k] & (xm & 3)) | (xp & 3));
+
+    for (c = 0; c < cmax; c = ce + 1) {  /* for each span */
+      /* check that tiles are not hidden behind foreground */
+      for (ce = c; ce < cmax && !((fgnd >> ce) & 1); ce++);
+      if (ce == c)
+        continue;
+
+      draw_maskedCopy(f + c * 8, pict + c * 8, mask + c * 8, (ce - c) * 8);
 #ifdef ENABLE_CHEATS
-      if (game_cheat3) f[k] |= 4;
-#endif
-    }
+      if (game_cheat3) {
+        U8 k;
+        for (k = c * 8; k < ce * 8; k++)
+          f[k] |= 4;
       }
-      f += SYSVID_WIDTH;
+#endif
     }
-    fb += 8;
+    f += SYSVID_WIDTH;
   }
+  fb += cmax * 8;
 }
 #endif
 
@@ -491,6 +648,11 @@ draw_sprite2(U8 number, U16 x, U16 y, bool front)
  * Redraw the map behind a sprite
  * align to tile column and row, and clip
  *
+ * The tiles drawn are the map screen tiles, hence are recorded in the shadow
+ * as if draw_map had drawn them. This also makes the frame buffer a cache
+ * of the background: tiles the shadow says are there already (e.g. erased
+ * along with an overlapping entity) are not copied again.
+ *
  * x, y: sprite position (pixels, map).
  */
 void
@@ -517,16 +679,21 @@ draw_spriteBackground(U16 x, U16 y)
   cmax >>= 3;
   rmax >>= 3;
 
+  draw_statusDirty(xs, DRAW_MAP_Y + ys, cmax * 8, rmax * 8);
+
   /* draw */
   for (r = 0; r < rmax; r++) {  /* for each row */
-#ifdef GFXPC
-    draw_setfb(xs, ys + r * 8);
-#endif
-#ifdef GFXST
-    draw_setfb(xs, 8 + ys + r * 8);
-#endif
+    U32 *s = shadow[ymap + r - MAP_ROW_SCRTOP] + xmap;
+
+    draw_setfb(xs, DRAW_MAP_Y + ys + r * 8);
     for (c = 0; c < cmax; c++) {  /* for each column */
-      draw_tile(map_map[ymap + r][xmap + c]);
+      U8 tile = map_map(ymap + r)[xmap + c];
+
+      if (s[c] != DRAW_SHADOW(tile)) {
+        draw_tileAt(fb, tile);
+        s[c] = DRAW_SHADOW(tile);
+      }
+      fb += 8;
     }
   }
 }
@@ -535,65 +702,177 @@ draw_spriteBackground(U16 x, U16 y)
 /*
  * Draw entire map screen background tiles onto frame buffer.
  *
+ * Only the tiles which are not already in the frame buffer are drawn (see
+ * draw_shadow).
+ *
  * ASM 0af5, 0a54
+ * return: list of the rectangles drawn, NULL if none
  */
-void
+rect_t *
 draw_map(void)
 {
     U8 i, j;
+    S8 first, last;  /* first and last columns drawn */
+    rect_t *rects = NULL, **next = &rects;
 
     draw_tilesBank = map_tilesBank;
 
-    for (i = 0; i < 0x18; i++) /* 0x18 rows */
+    for (i = 0; i < DRAW_MAP_ROWS; i++) /* 0x18 rows */
     {
-#ifdef GFXPC
-        draw_setfb(-DRAW_XYMAP_SCRLEFT, (i * 8));
-#endif
-#ifdef GFXST
-        draw_setfb(-DRAW_XYMAP_SCRLEFT, 8 + (i * 8));
-#endif
-        for (j = 0; j < 0x20; j++)  /* 0x20 tiles per row */
+        draw_setfb(DRAW_MAP_X, DRAW_MAP_Y + (i * 8));
+        first = last = -1;
+        for (j = 0; j < DRAW_MAP_COLS; j++)  /* 0x20 tiles per row */
         {
-            draw_tile(map_map[i + 8][j]);
+            U8 tile = map_map(i + MAP_ROW_SCRTOP)[j];
+
+            if (shadow[i][j] != DRAW_SHADOW(tile))
+            {
+                draw_tileAt(fb + j * 8, tile);
+                shadow[i][j] = DRAW_SHADOW(tile);
+                if (first < 0) first = j;
+                last = j;
+            }
+        }
+
+        if (first >= 0)
+        {
+            rect_t *r = &game_ctx->draw_mapRects[i];
+
+            r->x = DRAW_MAP_X + first * 8;
+            r->y = DRAW_MAP_Y + i * 8;
+            r->width = (last - first + 1) * 8;
+            r->height = 8;
+            draw_statusDirty(r->x, r->y, r->width, r->height);
+            *next = r;
+            next = &r->next;
         }
     }
+    *next = NULL;
+
+    rects_merge(rects);
+    return rects;
 }
 
 
 /*
- * Draw status indicators
+ * Move the map screen one tile row up or down within the frame buffer
  *
- * ASM 0309
+ * What draw_map knows about the tiles moves along, and the row which comes
+ * into view is marked for redraw: draw_map then only draws that row, and
+ * the tiles sprites had been drawn over.
+ *
+ * up: move up (the map shows one more row at the bottom) if true, else down
  */
 void
-draw_drawStatus(void)
+draw_scrollMap(bool up)
+{
+  U8 *f = game_ctx->framebuffer + DRAW_MAP_X + DRAW_MAP_Y * SYSVID_WIDTH;
+  U16 i;
+
+  draw_statusDirty(DRAW_MAP_X, DRAW_MAP_Y, DRAW_MAP_COLS * 8, DRAW_MAP_ROWS * 8);
+
+  if (up) {
+    for (i = 0; i < (DRAW_MAP_ROWS - 1) * 8; i++, f += SYSVID_WIDTH)
+      memcpy(f, f + 8 * SYSVID_WIDTH, DRAW_MAP_COLS * 8);
+    memmove(shadow[0], shadow[1], (DRAW_MAP_ROWS - 1) * sizeof(shadow[0]));
+    memset(shadow[DRAW_MAP_ROWS - 1], 0xff, sizeof(shadow[0]));
+  }
+  else {
+    f += (DRAW_MAP_ROWS - 1) * 8 * SYSVID_WIDTH;
+    for (i = 0; i < (DRAW_MAP_ROWS - 1) * 8; i++) {
+      f -= SYSVID_WIDTH;
+      memcpy(f + 8 * SYSVID_WIDTH, f, DRAW_MAP_COLS * 8);
+    }
+    memmove(shadow[1], shadow[0], (DRAW_MAP_ROWS - 1) * sizeof(shadow[0]));
+    memset(shadow[0], 0xff, sizeof(shadow[0]));
+  }
+}
+
+
+/*
+ * Get the tiles of the status indicators, 0 for cells without any
+ *
+ * Counters have room for 6 tiles. Score digits are only recomputed when
+ * the score changes.
+ *
+ * tiles: DRAW_STATUS_CELLS tiles, CHANGED
+ */
+static void
+draw_statusTiles(U8 *tiles)
 {
   S8 i;
   U32 sv;
-  static U8 s[7] = {0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xfe};
 
-  draw_tilesBank = 0;
-
-  for (i = 5, sv = game_score; i >= 0; i--) {
-    s[i] = 0x30 + (U8)(sv % 10);
-    sv /= 10;
+  if (status.score != game_score) {
+    for (i = 5, sv = game_score; i >= 0; i--) {
+      status.digits[i] = 0x30 + (U8)(sv % 10);
+      sv /= 10;
+    }
+    status.score = game_score;
   }
-  draw_tllst = s;
 
-  draw_setfb(DRAW_STATUS_SCORE_X, DRAW_STATUS_Y);
-  draw_tilesList();
+  memset(tiles, 0, DRAW_STATUS_CELLS);
+  memcpy(tiles, status.digits, sizeof(status.digits));
+  for (i = 0; i < game_bullets && i < 6; i++)
+    tiles[DRAW_STATUS_CELL(DRAW_STATUS_BULLETS_X) + i] = TILES_BULLET;
+  for (i = 0; i < game_bombs && i < 6; i++)
+    tiles[DRAW_STATUS_CELL(DRAW_STATUS_BOMBS_X) + i] = TILES_BOMB;
+  for (i = 0; i < game_lives && i < 6; i++)
+    tiles[DRAW_STATUS_CELL(DRAW_STATUS_LIVES_X) + i] = TILES_RICK;
+}
 
-  draw_setfb(DRAW_STATUS_BULLETS_X, DRAW_STATUS_Y);
-  for (i = 0; i < game_bullets; i++)
-    draw_tile(TILES_BULLET);
 
-  draw_setfb(DRAW_STATUS_BOMBS_X, DRAW_STATUS_Y);
-  for (i = 0; i < game_bombs; i++)
-    draw_tile(TILES_BOMB);
+/*
+ * Draw a status bar cell, unless the tile is there already
+ *
+ * c: cell
+ * tile: tile number
+ * draw_tilesBank, draw_filter: as for draw_tile
+ */
+static void
+draw_statusCell(U8 c, U8 tile)
+{
+  if (status.cells[c] == DRAW_SHADOW(tile))
+    return;
 
-  draw_setfb(DRAW_STATUS_LIVES_X, DRAW_STATUS_Y);
-  for (i = 0; i < game_lives; i++)
-    draw_tile(TILES_RICK);
+  draw_setfb(DRAW_STATUS_SCORE_X + c * 8, DRAW_STATUS_Y);
+  draw_tile(tile);
+  status.cells[c] = DRAW_SHADOW(tile);
+
+  if (status.first < 0 || c < status.first) status.first = c;
+  if (c > status.last) status.last = c;
+}
+
+
+/*
+ * Draw status indicators
+ *
+ * Only the cells which changed are drawn, and draw_STATUSRECT is set to
+ * cover them, as well as the cells draw_clearStatus drew. It is empty when
+ * there are none.
+ *
+ * ASM 0309
+ */
+void
+draw_drawStatus(void)
+{
+  U8 tiles[DRAW_STATUS_CELLS];
+  U8 c;
+
+  draw_tilesBank = 0;
+
+  draw_statusTiles(tiles);
+  for (c = 0; c < DRAW_STATUS_CELLS; c++)
+    if (tiles[c])
+      draw_statusCell(c, tiles[c]);
+
+  if (status.first < 0) {
+    draw_STATUSRECT.width = 0;
+    return;
+  }
+  draw_STATUSRECT.x = DRAW_STATUS_SCORE_X + status.first * 8;
+  draw_STATUSRECT.width = (status.last - status.first + 1) * 8;
+  status.first = status.last = -1;
 }
 
 
@@ -622,11 +901,17 @@ draw_infos(void)
 
 /*
  * Clear status indicators
+ *
+ * Only the cells without indicators are cleared: draw_drawStatus draws
+ * over the others. Cells already clear are left alone.
  */
 void
 draw_clearStatus(void)
 {
-  U8 i;
+  U8 tiles[DRAW_STATUS_CELLS];
+  U8 c;
+
+  draw_statusTiles(tiles);
 
 #ifdef GFXPC
   draw_tilesBank = map_tilesBank;
@@ -634,13 +919,14 @@ draw_clearStatus(void)
 #ifdef GFXST
   draw_tilesBank = 0;
 #endif
-  draw_setfb(DRAW_STATUS_SCORE_X, DRAW_STATUS_Y);
-  for (i = 0; i < DRAW_STATUS_LIVES_X/8 + 6 - DRAW_STATUS_SCORE_X/8; i++) {
+  for (c = 0; c < DRAW_STATUS_CELLS; c++) {
+    if (tiles[c])
+      continue;
 #ifdef GFXPC
-    draw_tile(map_map[MAP_ROW_SCRTOP + (DRAW_STATUS_Y / 8)][i]);
+    draw_statusCell(c, map_map(MAP_ROW_SCRTOP + (DRAW_STATUS_Y / 8))[c]);
 #endif
 #ifdef GFXST
-    draw_tile('@');
+    draw_statusCell(c, '@');
 #endif
   }
 }
@@ -652,21 +938,17 @@ draw_clearStatus(void)
 void
 draw_pic(const pic_t * picture)
 {
-    U8 *f;
-    U16 i, j, k, pp;
-    U32 v;
+    U16 i, n;
+    const U32 *p;
 
     draw_setfb(picture->xPos, picture->yPos);
-    pp = 0;
+    draw_invalidate();
+    p = picture->pixels;
+    n = picture->width / 8;  /* 8 pixels per word */
 
     for (i = 0; i < picture->height; i++) { /* rows */
-        f = fb;
-        for (j = 0; j < picture->width; j += 8) {  /* cols */
-            v = picture->pixels[pp++];
-            for (k = 8; k--; v >>= 4)
-                f[k] = v & 0x0F;
-            f += 8;
-        }
+        unpack_nibbles(fb, p, n);
+        p += n;
         fb += SYSVID_WIDTH;
     }
 }
@@ -679,21 +961,19 @@ draw_pic(const pic_t * picture)
 void
 draw_img(img_t *image)
 {
-    U8 *f;
-    U16 i, j, pp;
+    U16 i;
+    const U8 *p;
 
     sysvid_setPalette(image->colors, image->ncolors);
 
     draw_setfb(image->xPos, image->yPos);
-    pp = 0;
+    draw_invalidate();
+    p = image->pixels;
 
     for (i = 0; i < image->height; i++) /* rows */
     {
-        f = fb;
-        for (j = 0; j < image->width; j++) /* cols */
-        {
-            f[j] = image->pixels[pp++];
-        }
+        memcpy(fb, p, image->width);
+        p += image->width;
         fb += SYSVID_WIDTH;
     }
 }
@@ -17,6 +17,7 @@
 #define _DRAW_H
 
 #include "xrick/rects.h"
+#include "xrick/context.h"
 #include "xrick/data/img.h"
 #ifdef GFXST
 #include "xrick/data/pics.h"
@@ -30,18 +31,17 @@
 /* map coordinates of the top of the hidden bottom of the map */
 #define DRAW_XYMAP_HBTOP (0x0100)
 
-extern U8 *draw_tllst;
-#ifdef GFXPC
-extern U16 draw_filter;
-#endif
-extern U8 draw_tilesBank;
+/* draw_tllst, draw_filter, draw_tilesBank, draw_STATUSRECT: see context.h */
 
-extern rect_t draw_STATUSRECT;
 extern const rect_t draw_SCREENRECT; /* whole fb */
+extern const rect_t draw_MAPRECT; /* map screen and status bar */
 
 extern size_t game_color_count;
 extern img_color_t *game_colors;
 
+extern void draw_initContext(U8 *);
+extern void draw_clear(void);
+extern void draw_invalidate(void);
 extern void draw_setfb(U16, U16);
 extern bool draw_clipms(S16 *, S16 *, U16 *, U16 *);
 extern void draw_tilesList(void);
@@ -51,7 +51,8 @@ extern void draw_tile(register U8);
 extern void draw_sprite(U8, U16, U16);
 extern void draw_sprite2(U8, U16, U16, bool);
 extern void draw_spriteBackground(U16, U16);
-extern void draw_map(void);
+extern rect_t *draw_map(void);
+extern void draw_scrollMap(bool);
 extern void draw_drawStatus(void);
 extern void draw_clearStatus(void);
 #ifdef GFXST
@@ -23,18 +23,6 @@
 #include "xrick/data/sounds.h"
 #endif
 
-/*
- * public vars (for performance reasons)
- */
-bool e_bomb_lethal;
-U8 e_bomb_xc;
-U16 e_bomb_yc;
-
-/*
- * private vars
- */
-U8 e_bomb_ticker;
-
 /*
  * Bomb hit test
  *
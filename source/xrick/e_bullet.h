@@ -17,12 +17,12 @@
 #define _E_BULLET_H
 
 #include "xrick/system/basic_types.h"
+#include "xrick/context.h"
 
 #define E_BULLET_NO 2
 #define E_BULLET_ENT ent_ents[E_BULLET_NO]
 
-extern S8 e_bullet_offsx;
-extern S16 e_bullet_xc, e_bullet_yc;
+/* e_bullet_offsx, e_bullet_xc, e_bullet_yc: see context.h */
 
 extern void e_bullet_init(U16, U16);
 extern void e_bullet_action(U8);
@@ -25,13 +25,6 @@
 #include "xrick/maps.h"
 #include "xrick/util.h"
 
-/*
- * public vars
- */
-S16 e_rick_stop_x = 0;
-S16 e_rick_stop_y = 0;
-unsigned e_rick_state = 0;
-
 /*
 * public functions
 */
@@ -41,20 +34,22 @@ extern inline bool e_rick_state_test(e_rick_state_t s);
 
 
 /*
- * local vars
+ * local vars (see context.h)
  */
-static U8 scrawl;
+#define scrawl (game_ctx->e_rick.scrawl)
 
-static bool trigger = false;
+#define trigger (game_ctx->e_rick.trigger)
 
-static S8 offsx;
-static U8 ylow;
-static S16 offsy;
+#define offsx (game_ctx->e_rick.offsx)
+#define ylow (game_ctx->e_rick.ylow)
+#define offsy (game_ctx->e_rick.offsy)
 
-static U8 seq;
+#define seq (game_ctx->e_rick.seq)
 
-static U8 save_crawl, save_direction;
-static U16 save_x, save_y;
+#define save_crawl (game_ctx->e_rick.save_crawl)
+#define save_direction (game_ctx->e_rick.save_direction)
+#define save_x (game_ctx->e_rick.save_x)
+#define save_y (game_ctx->e_rick.save_y)
 
 
 /*
@@ -468,7 +463,7 @@ e_rick_action2(void)
  */
 void e_rick_action(U8 e/*unused*/)
 {
-    static U8 stopped = false; /* is this the most elegant way? */
+#define stopped (game_ctx->e_rick.stopped) /* is this the most elegant way? */
 
     (void)e;
 
@@ -552,6 +547,7 @@ void e_rick_action(U8 e/*unused*/)
 #endif
 
     E_RICK_ENT.sprite = (seq >> 2) + 1 + (game_dir ? 0x0c : 0x00);
+#undef stopped
 }
 
 
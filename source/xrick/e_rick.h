@@ -17,6 +17,7 @@
 #define _E_RICK_H
 
 #include "xrick/system/basic_types.h"
+#include "xrick/context.h"
 
 #define E_RICK_NO 1
 #define E_RICK_ENT ent_ents[E_RICK_NO]
@@ -32,12 +33,12 @@ typedef enum
     E_RICK_STCRAWL = (1 << 6),
 } e_rick_state_t;
 
-extern unsigned e_rick_state;
+/* e_rick_state: see context.h */
 inline void e_rick_state_set(e_rick_state_t s) { e_rick_state |= s; }
 inline void e_rick_state_clear(e_rick_state_t s) { e_rick_state &= ~s; }
 inline bool e_rick_state_test(e_rick_state_t s) { return e_rick_state & s; }
 
-extern S16 e_rick_stop_x, e_rick_stop_y;
+/* e_rick_stop_x, e_rick_stop_y: see context.h */
 
 extern void e_rick_save(void);
 extern void e_rick_restore(void);
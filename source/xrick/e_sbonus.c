@@ -22,14 +22,6 @@
 #include "xrick/e_rick.h"
 
 
-/*
- * public vars
- */
-bool e_sbonus_counting = false;
-U8 e_sbonus_counter = 0;
-U16 e_sbonus_bonus = 0;
-
-
 /*
  * Entity action / start counting
  *
@@ -17,10 +17,9 @@
 #define _E_SBONUS_H
 
 #include "xrick/system/basic_types.h"
+#include "xrick/context.h"
 
-extern bool e_sbonus_counting;
-extern U8 e_sbonus_counter;
-extern U16 e_sbonus_bonus;
+/* e_sbonus_counting, e_sbonus_counter, e_sbonus_bonus: see context.h */
 
 extern void e_sbonus_start(U8);
 extern void e_sbonus_stop(U8);
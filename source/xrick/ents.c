@@ -35,13 +35,9 @@
 /*
  * global vars
  */
-ent_t ent_ents[ENT_ENTSNUM + 1];
-
 size_t ent_nbr_entdata = 0;
 entdata_t *ent_entdata = NULL;
 
-rect_t *ent_rects = NULL;
-
 size_t ent_nbr_sprseq = 0;
 U8 *ent_sprseq = NULL;
 
@@ -354,14 +350,14 @@ ent_draw(void)
 {
   U8 i;
 #ifdef ENABLE_CHEATS
-  static bool ch3 = false;
+#define ch3 (game_ctx->ent_ch3)
 #endif
   S16 dx, dy;
 
   draw_tilesBank = map_tilesBank;
 
-  /* reset rectangles list */
-  rects_free(ent_rects);
+  /* reset rectangles list: the previous one, if drawn during this frame,
+     is released along with the frame, see game_step */
   ent_rects = NULL;
 
   /*sys_printf("\n");*/
@@ -454,8 +450,12 @@ ent_draw(void)
     ent_ents[i].prev_s = ent_ents[i].sprite;
   }
 
+  /* entities close to each other have overlapping rectangles */
+  rects_merge(ent_rects);
+
 #ifdef ENABLE_CHEATS
   ch3 = game_cheat3;
+#undef ch3
 #endif
 }
 
@@ -50,7 +50,7 @@
 #define ENT_FLG_TRIGSTOP 0x40
 #define ENT_FLG_TRIGRICK 0x80
 
-typedef struct {
+typedef struct ent_s {
   U8 n;          /* b00 */
   /*U8 b01;*/    /* b01 in ASM code but never used */
   S16 x;         /* b02 - position */
@@ -94,12 +94,12 @@ typedef struct {
 } mvstep_t;
 
 enum { ENT_ENTSNUM = 12 };
-extern ent_t ent_ents[ENT_ENTSNUM + 1];
+/* ent_ents: see context.h */
 
 extern size_t ent_nbr_entdata;
 extern entdata_t *ent_entdata;
 
-extern rect_t *ent_rects;
+/* ent_rects: see context.h */
 
 extern size_t ent_nbr_sprseq;
 extern U8 *ent_sprseq;
@@ -31,62 +31,36 @@
 #include "xrick/devtools.h"
 #endif
 
-
-/*
- * local typedefs
- */
-typedef enum {
-#ifdef ENABLE_DEVTOOLS
-  DEVTOOLS,
-#endif
-  XRICK,
-  INIT_GAME, INIT_BUFFER,
-  INTRO_MAIN, INTRO_MAP,
-  PAUSE_PRESSED1, PAUSE_PRESSED1B, PAUSED, PAUSE_PRESSED2,
-  PLAY0, PLAY1, PLAY2, PLAY3,
-  CHAIN_SUBMAP, CHAIN_MAP, CHAIN_END,
-  SCROLL_UP, SCROLL_DOWN,
-  RESTART, GAMEOVER, GETNAME, EXIT
-} game_state_t;
+#include <string.h> /* memcpy, memset */
 
 
 /*
- * global vars
+ * local vars
  */
-U8 game_period = 0;
-bool game_waitevt = false;
-const rect_t *game_rects = NULL;
-
-U8 game_lives = 0;
-U8 game_bombs = 0;
-U8 game_bullets = 0;
-U32 game_score = 0;
-
-U16 game_map = 0;
-U16 game_submap = 0;
+static game_ctx_t mainContext;  /* context of the game run by game_run */
 
-U8 game_dir = RIGHT;
-bool game_chsm = false;
-
-bool game_cheat1 = false;
-bool game_cheat2 = false;
-bool game_cheat3 = false;
+#define isave_frow (game_ctx->game_isave_frow)
+#define game_state (game_ctx->game_state)
+#define startMap (game_ctx->game_startMap)
+#define startSubmap (game_ctx->game_startSubmap)
+#define drawPending (game_ctx->game_drawPending)
+#ifdef ENABLE_SOUND
+#define currentMusic (game_ctx->game_currentMusic)
+#endif
 
 
 /*
- * local vars
+ * global vars
  */
-static U8 isave_frow;
-static game_state_t game_state;
-#ifdef ENABLE_SOUND
-static sound_t *currentMusic = NULL;
-#endif
+THREAD_LOCAL game_ctx_t *game_ctx = &mainContext;
 
 
 /*
  * prototypes
  */
 static void frame(void);
+static void drawPlay(void);
+static void flushDraw(void);
 static void init(void);
 static void play0(void);
 static void play3(void);
@@ -109,6 +83,14 @@ game_toggleCheat(cheat_t cheat)
 #endif
         game_state != XRICK && game_state != EXIT)
     {
+#ifdef ENABLE_REPLAY
+        /* cheats are not recorded: do not let them break a replay */
+        if (sysarg_args_record || sysrec_replaying)
+        {
+            return;
+        }
+#endif
+
         switch (cheat)
         {
             case Cheat_UNLIMITED_ALL:
@@ -168,85 +150,384 @@ game_stopmusic(void)
 }
 #endif /*ENABLE_SOUND */
 
+/*
+ * Load data shared by all contexts
+ *
+ * return: true on success
+ */
+bool
+game_loadData(void)
+{
+    if (!resources_load())
+    {
+        resources_unload();
+        return false;
+    }
+
+    if (map_nbr_marks > GAME_SNAPSHOT_MAXMARKS)
+    {
+        sys_error("(game) too many marks for snapshots");
+        resources_unload();
+        return false;
+    }
+
+    if (!sys_cacheData())
+    {
+        sys_uncacheData();
+        resources_unload();
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Unload data shared by all contexts
+ */
+void
+game_unloadData(void)
+{
+    sys_uncacheData();
+    resources_unload();
+}
+
+/*
+ * Initialise a context, i.e. set up a new game in it
+ *
+ * ctx: the context
+ * fb: frame buffer the game draws into, SYSVID_WIDTH by SYSVID_HEIGHT
+ * return: true on success
+ *
+ * Data must have been loaded. The current context is left unchanged.
+ */
+bool
+game_initContext(game_ctx_t *ctx, U8 *fb)
+{
+    game_ctx_t *previous;
+    sysmem_stack_t *stack;
+    bool success = false;
+
+    memset(ctx, 0, sizeof(*ctx));
+    sysmem_initStack(&ctx->stack, ctx->stackBuffer, sizeof(ctx->stackBuffer));
+
+    previous = game_setContext(ctx);
+    stack = sysmem_setStack(&ctx->stack);
+
+    /* marks and high scores get modified while playing */
+    map_marks = sysmem_push(map_nbr_marks * sizeof(*map_marks), SYSMEM_TAG_GAME);
+    screen_highScores = sysmem_push(screen_nbr_hiscores * sizeof(*screen_highScores), SYSMEM_TAG_GAME);
+    if (map_marks && screen_highScores)
+    {
+        memcpy(map_marks, map_marks_init, map_nbr_marks * sizeof(*map_marks));
+        memcpy(screen_highScores, screen_highScores_init, screen_nbr_hiscores * sizeof(*screen_highScores));
+        success = true;
+    }
+    sysmem_mark(&ctx->frameMark, "frame");
+
+    draw_initContext(fb);
+    control_active = true;
+    ctx->imain.first = true;
+
+    game_dir = RIGHT;
+    game_period = sysarg_args_period ? sysarg_args_period : GAME_PERIOD;
+    startMap = sysarg_args_map;
+    startSubmap = sysarg_args_submap;
+    game_state = XRICK;
+
+    sysmem_setStack(stack);
+    game_setContext(previous);
+    return success;
+}
+
+/*
+ * Release what a context holds
+ *
+ * The current context is left unchanged.
+ */
+void
+game_freeContext(game_ctx_t *ctx)
+{
+    game_ctx_t *previous = game_setContext(ctx);
+    sysmem_stack_t *stack = sysmem_setStack(&ctx->stack);
+
+    sysmem_release(&ctx->frameMark);
+    ent_rects = NULL;
+    draw_STATUSRECT.next = NULL;
+    sysmem_pop(screen_highScores);
+    screen_highScores = NULL;
+    sysmem_pop(map_marks);
+    map_marks = NULL;
+
+    sysmem_setStack(stack);
+    sysmem_freeStack(&ctx->stack);
+    game_setContext(previous);
+}
+
+/*
+ * Make a context the current one of the calling thread
+ *
+ * return: previous context
+ */
+game_ctx_t *
+game_setContext(game_ctx_t *ctx)
+{
+    game_ctx_t *previous = game_ctx;
+
+    game_ctx = ctx;
+    return previous;
+}
+
+/*
+ * Run one frame of the current context
+ *
+ * return: false once the game is over and wants to exit
+ *
+ * When returning, game_rects contains every parts of the frame buffer
+ * that have been modified, and remains valid until the next call.
+ *
+ * When game_skipDraw is set, the frame is not meant to be presented:
+ * entities and status bar are not drawn, hence game_rects is NULL unless
+ * something else (map, screen...) was. They are drawn again by the next
+ * frame without game_skipDraw, or before anything gets drawn over them.
+ */
+bool
+game_step(void)
+{
+    sysmem_stack_t *stack;
+
+    if (game_state == EXIT)
+    {
+        return false;
+    }
+
+    /* rectangles are allocated on the context memory stack */
+    stack = sysmem_setStack(&game_ctx->stack);
+
+    /* release what the previous frame allocated, rectangles list included,
+     * and drop the pointers into it */
+    sysmem_release(&game_ctx->frameMark);
+    ent_rects = NULL;
+    draw_STATUSRECT.next = NULL;
+
+    frame();
+    game_time += game_period;
+
+    sysmem_setStack(stack);
+    return true;
+}
+
+/*
+ * Save the state of the current game
+ *
+ * Snapshots hold plain values only, hence can be loaded into any context
+ * of the same build running on the same data. The frame buffer is not
+ * part of them: its owner copies it alongside when pixels matter.
+ */
+void
+game_saveState(game_snapshot_t *snapshot)
+{
+    size_t i;
+
+    memcpy(snapshot->state, game_ctx, GAME_CTX_STATE_SIZE);
+
+    memset(snapshot->marks, 0, sizeof(snapshot->marks));
+    for (i = 0; i < map_nbr_marks; i++)
+    {
+        if (map_marks[i].ent & MAP_MARK_NACT)
+        {
+            snapshot->marks[i >> 3] |= 1 << (i & 7);
+        }
+    }
+}
+
+/*
+ * Restore the state of the current game from a snapshot
+ *
+ * Takes effect at the next game_step.
+ */
+void
+game_loadState(const game_snapshot_t *snapshot)
+{
+    size_t i;
+
+    memcpy(game_ctx, snapshot->state, GAME_CTX_STATE_SIZE);
+    draw_invalidate();  /* the map may differ from what is in the frame buffer */
+
+    for (i = 0; i < map_nbr_marks; i++)
+    {
+        if (snapshot->marks[i >> 3] & (1 << (i & 7)))
+        {
+            map_marks[i].ent |= MAP_MARK_NACT;
+        }
+        else
+        {
+            map_marks[i].ent &= ~MAP_MARK_NACT;
+        }
+    }
+}
+
 /*
  * Main loop
  */
 void
 game_run(void)
 {
-    U32 currentTime,
+    U32 currentTime, nextFrameTime, nextTime;
 #ifdef ENABLE_SOUND
-        lastSoundTime = 0,
+    U32 nextSoundTime;
 #endif
-        lastFrameTime = 0;
+    U32 frames = 0, missedFrames = 0;
+    U32 turbo = sysarg_args_turbo, steps = 0;
+    bool fastForward = false, present, fullRefresh = false;
+    game_ctx_t *previous;
 
-    if (!resources_load())
+    if (!game_loadData())
     {
-        resources_unload();
         return;
     }
 
-    if (!sys_cacheData())
+    if (!game_initContext(&mainContext, sysvid_fb))
     {
-        sys_uncacheData();
+        game_unloadData();
         return;
     }
+    previous = game_setContext(&mainContext);
 
-    game_period = sysarg_args_period ? sysarg_args_period : GAME_PERIOD;
-    game_state = XRICK;
+#ifdef ENABLE_REPLAY
+    /* replays run as fast as possible */
+    fastForward = sysrec_replaying;
+    e_them_rndseed = sysrec_seed;
+#endif
 
-    /* main loop */
+    /*
+     * main loop
+     *
+     * Frames are due on a fixed grid of deadlines, one game period apart,
+     * so that sleeping too long before a frame is made up for before the
+     * next one. A frame that starts a whole period or more late means
+     * deadlines were missed: they are counted, and the grid restarts from
+     * now rather than catching up with a burst of frames.
+     *
+     * In turbo mode, each presented frame is preceded by turbo - 1 game
+     * steps that are not drawn, or (turbo 0) steps run as fast as possible
+     * and a frame is presented whenever one is due.
+     */
+    nextFrameTime = sys_gettime();
+#ifdef ENABLE_SOUND
+    nextSoundTime = nextFrameTime;
+#endif
     while (game_state != EXIT)
     {
         currentTime = sys_gettime();
 
-        if (currentTime - lastFrameTime >= game_period)
+        if (fastForward || turbo == 0 || (S32)(currentTime - nextFrameTime) >= 0)
         {
-            /* frame */
-            frame();
+            if (turbo == 0)
+            {
+                present = (S32)(currentTime - nextFrameTime) >= 0;
+            }
+            else
+            {
+                present = ++steps >= turbo;
+            }
 
-            /* video */
-            /*DEBUG*//*game_rects=&draw_SCREENRECT;*//*DEBUG*/
-            sysvid_update(game_rects);
+            if (present && !fastForward && currentTime - nextFrameTime >= game_period)
+            {
+                missedFrames += (currentTime - nextFrameTime) / game_period;
+                nextFrameTime = currentTime;
+            }
 
-            /* reset rectangles list */
-            rects_free(ent_rects);
-            ent_rects = NULL;
-            draw_STATUSRECT.next = NULL;  /* FIXME freerects should handle this */
+            /* frame */
+            game_skipDraw = !present;
+            game_step();
+            frames++;
 
-            /* events */
-            if (game_waitevt)
+            if (!present)
             {
-                sysevt_wait();  /* wait for an event */
+                /* whatever skipped frames draw must be refreshed eventually */
+                fullRefresh |= game_rects != NULL;
             }
             else
             {
-                sysevt_poll();  /* process events (non-blocking) */
+                steps = 0;
+                nextFrameTime += game_period;
+
+                /* events, polled before the frame is handed over to the
+                 * presenter thread, if any, so as not to wait for it */
+                if (!game_waitevt || fastForward)
+                {
+                    SYSPROF(SYSPROF_EVENTS, sysevt_poll());  /* process events (non-blocking) */
+                }
+
+                /* video */
+                /*DEBUG*//*game_rects=&draw_SCREENRECT;*//*DEBUG*/
+                SYSPROF(SYSPROF_VIDEO, sysvid_update(fullRefresh ? &draw_SCREENRECT : game_rects));
+                fullRefresh = false;
+#ifdef ENABLE_NULL_SYSTEM
+                /* --frames: stop right after that many frames are presented */
+                if (sysarg_args_frames && sysvid_frames >= sysarg_args_frames)
+                {
+                    game_state = EXIT;
+                }
+#endif
+#ifdef ENABLE_OBSERVE
+                sysobs_update();
+#endif
+
+                /* wait for an event, once the frame is on screen */
+                if (game_waitevt && !fastForward)
+                {
+                    sysevt_wait();
+                    nextFrameTime = sys_gettime();  /* not late, just idle */
+                }
             }
 
-            lastFrameTime = currentTime;
+#ifdef ENABLE_REPLAY
+            /* record or replay controls */
+            sysrec_update();
+#endif
         }
 
 #ifdef ENABLE_SOUND
-        if (currentTime - lastSoundTime >= syssnd_period)
+        if ((S32)(currentTime - nextSoundTime) >= 0)
         {
             /* sound */
             syssnd_update();
 
-            lastSoundTime = currentTime;
+            nextSoundTime = currentTime + syssnd_period;
         }
 #endif /* ENABLE_SOUND */
 
-        sys_yield();
+        if (!fastForward && turbo != 0)
+        {
+            /* sleep until whatever is due next */
+            nextTime = nextFrameTime;
+#ifdef ENABLE_SOUND
+            if ((S32)(nextSoundTime - nextTime) < 0)
+            {
+                nextTime = nextSoundTime;
+            }
+#endif
+            currentTime = sys_gettime();
+            if ((S32)(nextTime - currentTime) > 0)
+            {
+                sys_sleep(nextTime - currentTime);
+            }
+        }
+    }
+
+    if (!fastForward)
+    {
+        sys_printf("xrick/game: %u frames, %u missed deadlines\n", frames, missedFrames);
     }
 
 #ifdef ENABLE_SOUND
     syssnd_stopAll();
 #endif
 
-    sys_uncacheData();
+    game_freeContext(&mainContext);
+    game_setContext(previous);
 
-    resources_unload();
+    game_unloadData();
 }
 
 /*
@@ -259,6 +540,8 @@ game_run(void)
 static void
 frame(void)
 {
+    U8 scroll;
+
     while (1) {
 
         switch (game_state) {
@@ -340,9 +623,9 @@ frame(void)
 
 
         case INIT_BUFFER:
-            sysvid_clear();                 /* clear buffer */
-            draw_map();                     /* draw the map onto the buffer */
-            draw_drawStatus();              /* draw the status bar onto the buffer */
+            draw_clear();                   /* clear buffer */
+            SYSPROF(SYSPROF_DRAW_MAP, draw_map());  /* draw the map onto the buffer */
+            SYSPROF(SYSPROF_DRAW_STATUS, draw_drawStatus());  /* draw the status bar onto the buffer */
 #ifdef ENABLE_CHEATS
             draw_infos();                   /* draw the info bar onto the buffer */
 #endif
@@ -397,6 +680,7 @@ frame(void)
 
         case PLAY1:
             if (control_test(Control_PAUSE)) {
+                flushDraw();
 #ifdef ENABLE_SOUND
                 syssnd_pauseAll(true);
 #endif
@@ -404,6 +688,7 @@ frame(void)
                 game_state = PAUSE_PRESSED1;
             }
             else if (!control_active) {
+                flushDraw();
 #ifdef ENABLE_SOUND
                 syssnd_pauseAll(true);
 #endif
@@ -422,6 +707,7 @@ frame(void)
                 if (game_cheat1 || --game_lives) {
                     game_state = RESTART;
                 } else {
+                    flushDraw();
                     game_state = GAMEOVER;
                 }
             }
@@ -464,8 +750,8 @@ frame(void)
     return;
       case SCREEN_DONE:
     if (game_map >= map_nbr_maps - 1) {  /* reached end of game */
-      sysarg_args_map = 0;
-      sysarg_args_submap = 0;
+      startMap = 0;
+      startSubmap = 0;
       game_state = GAMEOVER;
     }
     else {  /* initialize game */
@@ -488,16 +774,17 @@ frame(void)
       map_init();                     /* initialize the map */
       isave();                        /* save data in case of a restart */
       ent_clprev();                   /* cleanup entities */
-      draw_map();                     /* draw the map onto the buffer */
-      draw_drawStatus();              /* draw the status bar onto the buffer */
-      game_rects = &draw_SCREENRECT;  /* request full screen refresh */
+      SYSPROF(SYSPROF_DRAW_MAP, draw_STATUSRECT.next = draw_map());  /* draw the map onto the buffer */
+      SYSPROF(SYSPROF_DRAW_STATUS, draw_drawStatus());  /* draw the status bar onto the buffer */
+      game_rects = &draw_STATUSRECT;  /* request refresh of what was drawn */
       game_state = PLAY0;
       return;
 
 
 
     case SCROLL_UP:
-      switch (scroll_up()) {
+      SYSPROF(SYSPROF_SCROLL_UP, scroll = scroll_up());
+      switch (scroll) {
       case SCROLL_RUNNING:
     return;
       case SCROLL_DONE:
@@ -509,7 +796,8 @@ frame(void)
 
 
     case SCROLL_DOWN:
-      switch (scroll_down()) {
+      SYSPROF(SYSPROF_SCROLL_DOWN, scroll = scroll_down());
+      switch (scroll) {
       case SCROLL_RUNNING:
     return;
       case SCROLL_DONE:
@@ -580,9 +868,9 @@ init(void)
   game_bullets = 6;
   game_score = 0;
 
-  game_map = sysarg_args_map;
+  game_map = startMap;
 
-  if (sysarg_args_submap == 0)
+  if (startSubmap == 0)
   {
       game_submap = map_maps[game_map].submap;
       map_frow = (U8)map_maps[game_map].row;
@@ -590,7 +878,7 @@ init(void)
   else
   {
       /* dirty hack to determine frow */
-      game_submap = sysarg_args_submap;
+      game_submap = startSubmap;
       i = 0;
       while (i < map_nbr_connect &&
             (map_connect[i].submap != game_submap ||
@@ -626,16 +914,18 @@ static void
 play0(void)
 {
     if (control_test(Control_END)) {  /* request to end the game */
+        flushDraw();
         game_state = GAMEOVER;
         return;
     }
 
     if (control_test(Control_EXIT)) {  /* request to exit the game */
+        flushDraw();
         game_state = EXIT;
         return;
     }
 
-    ent_action();      /* run entities */
+    SYSPROF(SYSPROF_ENT_ACTION, ent_action());  /* run entities */
     e_them_rndseed++;  /* (0270) */
 
     game_state = PLAY1;
@@ -649,13 +939,12 @@ play0(void)
 static void
 play3(void)
 {
-    draw_clearStatus();  /* clear the status bar */
-    ent_draw();          /* draw all entities onto the buffer */
-    /* sound */
-    draw_drawStatus();   /* draw the status bar onto the buffer*/
-
-    game_rects = &draw_STATUSRECT; /* refresh status bar too */
-    draw_STATUSRECT.next = ent_rects;  /* take care to cleanup draw_STATUSRECT->next later! */
+    if (game_skipDraw) {
+        drawPending = true;
+        game_rects = NULL;
+    }
+    else
+        drawPlay();
 
     if (!e_rick_state_test(E_RICK_STZOMBIE)) {  /* need to scroll ? */
         if (ent_ents[1].y >= 0xCC) {
@@ -672,6 +961,38 @@ play3(void)
 }
 
 
+/*
+ * Draw entities and status bar
+ *
+ */
+static void
+drawPlay(void)
+{
+    draw_clearStatus();  /* clear the status bar */
+    SYSPROF(SYSPROF_ENT_DRAW, ent_draw());  /* draw all entities onto the buffer */
+    /* sound */
+    SYSPROF(SYSPROF_DRAW_STATUS, draw_drawStatus());  /* draw the status bar onto the buffer*/
+
+    game_rects = &draw_STATUSRECT; /* refresh status bar too */
+    draw_STATUSRECT.next = ent_rects;  /* reset when the frame is released, see game_step */
+
+    drawPending = false;
+}
+
+
+/*
+ * Draw entities and status bar if frames skipped drawing them,
+ * before leaving play (pause, game over, exit)
+ *
+ */
+static void
+flushDraw(void)
+{
+    if (drawPending)
+        drawPlay();
+}
+
+
 /*
  * restart
  *
@@ -690,9 +1011,9 @@ restart(void)
   map_init();
   isave();
   ent_clprev();
-  draw_map();
-  draw_drawStatus();
-  game_rects = &draw_SCREENRECT;
+  SYSPROF(SYSPROF_DRAW_MAP, draw_STATUSRECT.next = draw_map());
+  SYSPROF(SYSPROF_DRAW_STATUS, draw_drawStatus());
+  game_rects = &draw_STATUSRECT;
 }
 
 
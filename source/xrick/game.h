@@ -18,6 +18,7 @@
 
 #include "xrick/config.h"
 #include "xrick/rects.h"
+#include "xrick/context.h"
 #ifdef ENABLE_SOUND
 #include "xrick/data/sounds.h"
 #endif
@@ -32,24 +33,32 @@
 #define GAME_BOMBS_INIT 6
 #define GAME_BULLETS_INIT 6
 
-extern U8 game_lives;      /* lives counter */
-extern U8 game_bombs;      /* bombs counter */
-extern U8 game_bullets;    /* bullets counter */
-
-extern U32 game_score;     /* score */
-
-extern U16 game_map;       /* current map */
-extern U16 game_submap;    /* current submap */
-
-extern U8 game_dir;        /* direction (LEFT, RIGHT) */
-extern bool game_chsm;       /* change submap request (true, false) */
+/*
+ * snapshot of the state of a game, see game_saveState
+ */
+#define GAME_SNAPSHOT_MAXMARKS 1024
 
-extern bool game_waitevt;    /* wait for events (true, false) */
-extern U8 game_period;     /* time between each frame, in millisecond */
+typedef struct {
+  U8 state[GAME_CTX_STATE_SIZE];         /* game state part of the context */
+  U8 marks[GAME_SNAPSHOT_MAXMARKS / 8];  /* marks activity, one bit per mark */
+} game_snapshot_t;
 
-extern const rect_t *game_rects; /* rectangles to redraw at each frame */
+/*
+ * game_lives, game_bombs, game_bullets, game_score, game_map, game_submap,
+ * game_dir, game_chsm, game_waitevt, game_period, game_time, game_rects,
+ * game_skipDraw: see context.h
+ */
 
 extern void game_run(void);
+
+extern bool game_loadData(void);
+extern void game_unloadData(void);
+extern bool game_initContext(game_ctx_t *, U8 *);
+extern void game_freeContext(game_ctx_t *);
+extern game_ctx_t *game_setContext(game_ctx_t *);
+extern bool game_step(void);
+extern void game_saveState(game_snapshot_t *);
+extern void game_loadState(const game_snapshot_t *);
 #ifdef ENABLE_SOUND
 extern void game_setmusic(sound_t * sound, S8 loop);
 extern void game_stopmusic(void);
@@ -62,9 +71,7 @@ typedef enum
     Cheat_NEVER_DIE,
     Cheat_EXPOSE
 } cheat_t;
-extern bool game_cheat1;     /* infinite lives, bombs and bullets */
-extern bool game_cheat2;     /* never die */
-extern bool game_cheat3;     /* highlight sprites */
+/* game_cheat1, game_cheat2, game_cheat3: see context.h */
 extern void game_toggleCheat(cheat_t);
 #endif /* ENABLE_CHEATS */
 
@@ -43,8 +43,6 @@
 /*
  * global vars
  */
-U8 map_map[0x2C][0x20];
-
 size_t map_nbr_maps = 0;
 map_t *map_maps = NULL;
 
@@ -58,17 +56,13 @@ size_t map_nbr_blocks = 0;
 block_t *map_blocks = NULL;
 
 size_t map_nbr_marks = 0;
-mark_t *map_marks = NULL;
+mark_t *map_marks_init = NULL;
 
 size_t map_nbr_bnums = 0;
 U8 *map_bnums = NULL;
 
 size_t map_nbr_eflgc = 0;
 U8 *map_eflg_c = NULL;
-U8 map_eflg[0x100];
-
-U8 map_frow;
-U8 map_tilesBank;
 
 
 /*
@@ -98,10 +92,10 @@ map_expand(void)
   for (i = 0; i < 0x0b; i++) {  /* 0x0b rows of blocks */
     for (j = 0; j < 0x08; j++) {  /* 0x08 blocks per row */
       for (k = 0, l = 0; k < 0x04; k++) {  /* expand one block */
-    map_map[row][col++] = map_blocks[map_bnums[pbnum]][l++];
-    map_map[row][col++] = map_blocks[map_bnums[pbnum]][l++];
-    map_map[row][col++] = map_blocks[map_bnums[pbnum]][l++];
-    map_map[row][col]   = map_blocks[map_bnums[pbnum]][l++];
+    map_map(row)[col++] = map_blocks[map_bnums[pbnum]][l++];
+    map_map(row)[col++] = map_blocks[map_bnums[pbnum]][l++];
+    map_map(row)[col++] = map_blocks[map_bnums[pbnum]][l++];
+    map_map(row)[col]   = map_blocks[map_bnums[pbnum]][l++];
     row += 1; col -= 3;
       }
       row -= 4; col += 4;
@@ -109,6 +103,15 @@ map_expand(void)
     }
     row += 4; col = 0;
   }
+
+  /* foreground columns of each row */
+  for (row = 0; row < MAP_RING_ROWS; row++) {
+    U32 fgnd = 0;
+    for (col = 0; col < 0x20; col++)
+      if (map_eflg[map_map(row)[col]] & MAP_EFLG_FGND)
+        fgnd |= (U32)1 << col;
+    map_fgnd(row) = fgnd;
+  }
 }
 
 
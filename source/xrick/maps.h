@@ -36,7 +36,19 @@
 #define MAP_ROW_HBTOP 0x20
 #define MAP_ROW_HBBOT 0x27
 
-extern U8 map_map[0x2c][0x20];
+/*
+ * map_map is a ring of rows: map_map(row) is ring row map_rowBase + row,
+ * so that moving the map up or down one row is only a matter of changing
+ * map_rowBase. The ring holds the 0x2C rows which map_expand fills in.
+ */
+#define MAP_RING_ROWS 0x40
+
+/*
+ * map_fgnd(row) has bit c set when map_map(row)[c] is a foreground tile,
+ * hiding sprites which are behind it. It is computed by map_expand.
+ */
+
+/* map_map, map_rowBase, map_fgnd: see context.h */
 
 /*
  * main maps
@@ -106,7 +118,7 @@ typedef struct {
 } mark_t;
 
 extern size_t map_nbr_marks;
-extern mark_t *map_marks;
+extern mark_t *map_marks_init;  /* as loaded, see context.h for map_marks */
 
 /*
  * block numbers, i.e. array of rows of 8 blocks
@@ -115,7 +127,7 @@ extern size_t map_nbr_bnums;
 extern U8 *map_bnums;
 
 /*
- * flags for map_eflg[map_map[row][col]]  ("yes" when set)
+ * flags for map_eflg[map_map(row)[col]]  ("yes" when set)
  *
  * MAP_EFLG_VERT: vertical move only (usually on top of _CLIMB).
  * MAP_EFLG_SOLID: solid block, can't go through.
@@ -137,17 +149,12 @@ extern U8 *map_bnums;
 
 extern size_t map_nbr_eflgc;
 extern U8 *map_eflg_c;  /* compressed */
-extern U8 map_eflg[0x100];  /* current */
-
-/*
- * map_map top row within the submap
- */
-extern U8 map_frow;
+/* map_eflg: current, see context.h */
 
 /*
- * tiles offset
+ * map_frow: map_map top row within the submap, see context.h
+ * map_tilesBank: tiles offset, see context.h
  */
-extern U8 map_tilesBank;
 
 extern void map_expand(void);
 extern void map_init(void);
@@ -38,6 +38,10 @@
 /* development tools */
 #undef ENABLE_DEVTOOLS
 
+/* SSE2 / NEON pixel unpacking kernels (none of them on Rockbox targets) */
+#undef ENABLE_SIMD
+#undef ENABLE_PRESENTER
+
 /* Print debug info to screen */
 #undef ENABLE_SYSPRINTF_TO_SCREEN
 
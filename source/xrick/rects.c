@@ -16,22 +16,7 @@
 #include "xrick/rects.h"
 #include "xrick/system/system.h"
 
-/*
- * Free a list of rectangles and set the pointer to NULL.
- *
- * p: rectangle list CHANGED to NULL
- */
-void
-rects_free(rect_t *r)
-{
-    while (r)
-    {
-        rect_t * next = r->next;
-        sysmem_pop(r);
-        r = next;
-    }
-}
-
+enum { MERGE_RECT_COST = 512 };  /* pixels, see rects_merge */
 
 /*
  * Add a rectangle to a list of rectangles
@@ -41,7 +26,7 @@ rects_new(U16 x, U16 y, U16 width, U16 height, rect_t *next)
 {
     rect_t *r;
 
-    r = sysmem_push(sizeof(*r));
+    r = sysmem_push(sizeof(*r), SYSMEM_TAG_RECTS);
     if (!r)
     {
         return NULL;
@@ -54,4 +39,66 @@ rects_new(U16 x, U16 y, U16 width, U16 height, rect_t *next)
     return r;
 }
 
+
+/*
+ * Merge overlapping or close rectangles of a list
+ *
+ * Two rectangles are replaced by their bounding box when refreshing the
+ * bounding box costs no more than refreshing both rectangles, counting
+ * MERGE_RECT_COST pixels for each rectangle on top of its area. This is
+ * repeated until no pair of rectangles can be merged.
+ *
+ * Rectangles merged into others are not removed from the list, they are
+ * left empty instead (zero width and height): they stay allocated until
+ * the whole frame is released (see game_step).
+ *
+ * list: rectangle list CHANGED
+ */
+void
+rects_merge(rect_t *list)
+{
+    rect_t *a, *b;
+    U32 x0, y0, x1, y1;
+    bool merged;
+
+    do
+    {
+        merged = false;
+        for (a = list; a; a = a->next)
+        {
+            if (rects_isEmpty(a))
+            {
+                continue;
+            }
+            for (b = a->next; b; b = b->next)
+            {
+                if (rects_isEmpty(b))
+                {
+                    continue;
+                }
+
+                /* bounding box */
+                x0 = a->x < b->x ? a->x : b->x;
+                y0 = a->y < b->y ? a->y : b->y;
+                x1 = a->x + a->width > b->x + b->width ? a->x + a->width : b->x + b->width;
+                y1 = a->y + a->height > b->y + b->height ? a->y + a->height : b->y + b->height;
+
+                if ((x1 - x0) * (y1 - y0) > (U32)a->width * a->height +
+                                            (U32)b->width * b->height + MERGE_RECT_COST)
+                {
+                    continue;
+                }
+
+                a->x = (U16)x0;
+                a->y = (U16)y0;
+                a->width = (U16)(x1 - x0);
+                a->height = (U16)(y1 - y0);
+                b->width = 0;
+                b->height = 0;
+                merged = true;
+            }
+        }
+    } while (merged);
+}
+
 /* eof */
@@ -24,8 +24,11 @@ typedef struct rect_s {
   struct rect_s *next;
 } rect_t;
 
-extern void rects_free(rect_t *);
 extern rect_t *rects_new(U16, U16, U16, U16, rect_t *);
+extern void rects_merge(rect_t *);
+
+/* empty rectangles (merged into others by rects_merge) are to be skipped */
+#define rects_isEmpty(r) ((r)->width == 0 || (r)->height == 0)
 
 #endif /* ndef _RECTS_H */
 
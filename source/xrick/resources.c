@@ -17,6 +17,7 @@
 #include "xrick/ents.h"
 #include "xrick/maps.h"
 #include "xrick/util.h"
+#include "xrick/unpack.h"
 #include "xrick/data/sprites.h"
 #include "xrick/data/tiles.h"
 #include "xrick/data/pics.h"
@@ -50,8 +51,10 @@ static void unloadResourceImaptext(void);
 static bool loadResourceHighScores(file_t fp);
 static void unloadResourceHighScores(void);
 static bool loadResourceSpritesData(file_t fp);
+static bool expandSpritesData(void);
 static void unloadResourceSpritesData(void);
 static bool loadResourceTilesData(file_t fp);
+static bool expandTilesData(void);
 static void unloadResourceTilesData(void);
 static bool loadImage(file_t fp, img_t ** image);
 static void unloadImage(img_t ** image);
@@ -89,7 +92,7 @@ static bool loadString(file_t fp, char ** buffer, const char terminator)
     }
     length = letoh16(u16Temp);
 
-    bufferTemp = sysmem_push(length + 1);
+    bufferTemp = sysmem_push(length + 1, SYSMEM_TAG_RESOURCES);
     *buffer = bufferTemp;
     if (!bufferTemp)
     {
@@ -163,7 +166,7 @@ static bool loadResourceEntdata(file_t fp)
     }
     ent_nbr_entdata = letoh16(u16Temp);
 
-    ent_entdata = sysmem_push(ent_nbr_entdata * sizeof(*ent_entdata));
+    ent_entdata = sysmem_push(ent_nbr_entdata * sizeof(*ent_entdata), SYSMEM_TAG_RESOURCES);
     if (!ent_entdata)
     {
         return false;
@@ -210,7 +213,7 @@ static bool loadRawData(file_t fp, void ** buffer, const size_t size, size_t * c
     }
     *count = letoh16(u16Temp);
 
-    *buffer = sysmem_push((*count) * size);
+    *buffer = sysmem_push((*count) * size, SYSMEM_TAG_RESOURCES);
     if (!(*buffer))
     {
         return false;
@@ -248,7 +251,7 @@ static bool loadResourceMaps(file_t fp)
     }
     map_nbr_maps = letoh16(u16Temp);
 
-    map_maps = sysmem_push(map_nbr_maps * sizeof(*map_maps));
+    map_maps = sysmem_push(map_nbr_maps * sizeof(*map_maps), SYSMEM_TAG_RESOURCES);
     if (!map_maps)
     {
         return false;
@@ -308,7 +311,7 @@ static bool loadResourceSubmaps(file_t fp)
     }
     map_nbr_submaps = letoh16(u16Temp);
 
-    map_submaps = sysmem_push(map_nbr_submaps * sizeof(*map_submaps));
+    map_submaps = sysmem_push(map_nbr_submaps * sizeof(*map_submaps), SYSMEM_TAG_RESOURCES);
     if (!map_submaps)
     {
         return false;
@@ -357,7 +360,7 @@ static bool loadResourceImapsteps(file_t fp)
     }
     screen_nbr_imapstesps = letoh16(u16Temp);
 
-    screen_imapsteps = sysmem_push(screen_nbr_imapstesps * sizeof(*screen_imapsteps));
+    screen_imapsteps = sysmem_push(screen_nbr_imapstesps * sizeof(*screen_imapsteps), SYSMEM_TAG_RESOURCES);
     if (!screen_imapsteps)
     {
         return false;
@@ -405,7 +408,7 @@ static bool loadResourceImaptext(file_t fp)
     }
     screen_nbr_imaptext = letoh16(u16Temp);
 
-    screen_imaptext = sysmem_push(screen_nbr_imaptext * sizeof(*screen_imaptext));
+    screen_imaptext = sysmem_push(screen_nbr_imaptext * sizeof(*screen_imaptext), SYSMEM_TAG_RESOURCES);
     if (!screen_imapsteps)
     {
         return false;
@@ -454,8 +457,8 @@ static bool loadResourceHighScores(file_t fp)
     }
     screen_nbr_hiscores = letoh16(u16Temp);
 
-    screen_highScores = sysmem_push(screen_nbr_hiscores * sizeof(*screen_highScores));
-    if (!screen_highScores)
+    screen_highScores_init = sysmem_push(screen_nbr_hiscores * sizeof(*screen_highScores_init), SYSMEM_TAG_RESOURCES);
+    if (!screen_highScores_init)
     {
         return false;
     }
@@ -467,8 +470,8 @@ static bool loadResourceHighScores(file_t fp)
             return false;
         }
         memcpy(&u32Temp, dataTemp.score, sizeof(U32));
-        screen_highScores[i].score = letoh32(u32Temp);
-        memcpy(screen_highScores[i].name, dataTemp.name, HISCORE_NAME_SIZE);
+        screen_highScores_init[i].score = letoh32(u32Temp);
+        memcpy(screen_highScores_init[i].name, dataTemp.name, HISCORE_NAME_SIZE);
     }
     return true;
 }
@@ -478,8 +481,8 @@ static bool loadResourceHighScores(file_t fp)
  */
 static void unloadResourceHighScores()
 {
-    sysmem_pop(screen_highScores);
-    screen_highScores = NULL;
+    sysmem_pop(screen_highScores_init);
+    screen_highScores_init = NULL;
     screen_nbr_hiscores = 0;
 }
 
@@ -497,7 +500,7 @@ static bool loadResourceSpritesData(file_t fp)
     }
     sprites_nbr_sprites = letoh16(u16Temp);
 
-    sprites_data = sysmem_push(sprites_nbr_sprites * sizeof(*sprites_data));
+    sprites_data = sysmem_push(sprites_nbr_sprites * sizeof(*sprites_data), SYSMEM_TAG_RESOURCES);
     if (!sprites_data)
     {
         return false;
@@ -540,6 +543,57 @@ static bool loadResourceSpritesData(file_t fp)
     }
 #endif /* GFXPC */
 
+    return expandSpritesData();
+}
+
+/*
+ * Expand sprites to 8 bits per pixel, with a mask byte per pixel, once
+ * for all, so that drawing a sprite line is a masked copy
+ */
+static bool expandSpritesData()
+{
+    size_t i, r, k;
+#ifdef GFXPC
+    size_t j;
+#endif /* GFXPC */
+
+    sprites_pixels = sysmem_push(sprites_nbr_sprites * sizeof(*sprites_pixels), SYSMEM_TAG_RESOURCES);
+    if (!sprites_pixels)
+    {
+        return false;
+    }
+
+    for (i = 0; i < sprites_nbr_sprites; ++i)
+    {
+        for (r = 0; r < SPRITES_NBR_ROWS; ++r)
+        {
+#ifdef GFXST
+            unpack_nibbles(sprites_pixels[i].pict[r], &sprites_data[i][r * SPRITES_NBR_COLS], SPRITES_NBR_COLS);
+            for (k = 0; k < SPRITES_NBR_PIXELS; ++k)
+            {
+                /* colour 0 is transparent, others replace the low nibble */
+                sprites_pixels[i].mask[r][k] = sprites_pixels[i].pict[r][k] ? 0xf0 : 0xff;
+            }
+#endif /* GFXST */
+#ifdef GFXPC
+            for (k = 0; k < SPRITES_NBR_PAD; ++k)
+            {
+                sprites_pixels[i].mask[r][k] = 3;
+                sprites_pixels[i].pict[r][k] = 0;
+            }
+            for (j = 0; j < SPRITES_NBR_COLS; ++j)
+            {
+                U16 xm = sprites_data[i][j][r].mask;
+                U16 xp = sprites_data[i][j][r].pict;
+                for (k = 8; k--; xm >>= 2, xp >>= 2)
+                {
+                    sprites_pixels[i].mask[r][SPRITES_NBR_PAD + j * 8 + k] = xm & 3;
+                    sprites_pixels[i].pict[r][SPRITES_NBR_PAD + j * 8 + k] = xp & 3;
+                }
+            }
+#endif /* GFXPC */
+        }
+    }
     return true;
 }
 
@@ -548,6 +602,8 @@ static bool loadResourceSpritesData(file_t fp)
  */
 static void unloadResourceSpritesData()
 {
+    sysmem_pop(sprites_pixels);
+    sprites_pixels = NULL;
     sysmem_pop(sprites_data);
     sprites_data = NULL;
     sprites_nbr_sprites = 0;
@@ -567,7 +623,7 @@ static bool loadResourceTilesData(file_t fp)
     }
     tiles_nbr_banks = letoh16(u16Temp);
 
-    tiles_data = sysmem_push(tiles_nbr_banks * TILES_NBR_TILES * sizeof(*tiles_data));
+    tiles_data = sysmem_push(tiles_nbr_banks * TILES_NBR_TILES * sizeof(*tiles_data), SYSMEM_TAG_RESOURCES);
     if (!tiles_data)
     {
         return false;
@@ -597,6 +653,43 @@ static bool loadResourceTilesData(file_t fp)
             }
         }
     }
+    return expandTilesData();
+}
+
+/*
+ * Expand tiles to 8 bits per pixel, once for all, so that draw_tile
+ * only has to copy lines of pixels
+ */
+static bool expandTilesData()
+{
+    size_t nbr_tiles;
+
+    nbr_tiles = tiles_nbr_banks * TILES_NBR_TILES;
+#ifdef GFXPC
+    tiles_pixels = sysmem_push(TILES_NBR_FILTERS * nbr_tiles * sizeof(*tiles_pixels), SYSMEM_TAG_RESOURCES);
+#endif /* GFXPC */
+#ifdef GFXST
+    tiles_pixels = sysmem_push(nbr_tiles * sizeof(*tiles_pixels), SYSMEM_TAG_RESOURCES);
+#endif /* GFXST */
+    if (!tiles_pixels)
+    {
+        return false;
+    }
+
+    /* one word per tile line, all lines one after the other */
+#ifdef GFXPC
+    {
+        size_t f;
+        for (f = 0; f < TILES_NBR_FILTERS; ++f)
+        {
+            unpack_crumbs(tiles_pixels[f * nbr_tiles][0], tiles_data[0],
+                          nbr_tiles * TILES_NBR_LINES, tiles_filters[f]);
+        }
+    }
+#endif /* GFXPC */
+#ifdef GFXST
+    unpack_nibbles(tiles_pixels[0][0], tiles_data[0], nbr_tiles * TILES_NBR_LINES);
+#endif /* GFXST */
     return true;
 }
 
@@ -605,6 +698,8 @@ static bool loadResourceTilesData(file_t fp)
  */
 static void unloadResourceTilesData()
 {
+    sysmem_pop(tiles_pixels);
+    tiles_pixels = NULL;
     sysmem_pop(tiles_data);
     tiles_data = NULL;
     tiles_nbr_banks = 0;
@@ -622,7 +717,7 @@ static bool loadImage(file_t fp, img_t ** image)
     void * vp;
     bool success;
 
-    imgTemp = sysmem_push(sizeof(*imgTemp));
+    imgTemp = sysmem_push(sizeof(*imgTemp), SYSMEM_TAG_RESOURCES);
     *image = imgTemp;
     if (!imgTemp)
     {
@@ -653,7 +748,7 @@ static bool loadImage(file_t fp, img_t ** image)
 
     pixelCount = (imgTemp->width * imgTemp->height);  /*we use 8b per pixel*/
 
-    imgTemp->pixels = sysmem_push(pixelCount * sizeof(U8));
+    imgTemp->pixels = sysmem_push(pixelCount * sizeof(U8), SYSMEM_TAG_RESOURCES);
     if (!imgTemp->pixels)
     {
         return false;
@@ -691,7 +786,7 @@ static bool loadPicture(file_t fp, pic_t ** picture)
     resource_pic_t dataTemp;
     pic_t * picTemp;
 
-    picTemp = sysmem_push(sizeof(*picTemp));
+    picTemp = sysmem_push(sizeof(*picTemp), SYSMEM_TAG_RESOURCES);
     *picture = picTemp;
     if (!picTemp)
     {
@@ -713,7 +808,7 @@ static bool loadPicture(file_t fp, pic_t ** picture)
 
     pixelWords32b = (picTemp->width * picTemp->height) / 8;  /*we use 4b per pixel*/
 
-    picTemp->pixels = sysmem_push(pixelWords32b * sizeof(U32));
+    picTemp->pixels = sysmem_push(pixelWords32b * sizeof(U32), SYSMEM_TAG_RESOURCES);
     if (!picTemp->pixels)
     {
         return false;
@@ -809,7 +904,7 @@ static bool loadSound(const unsigned id)
         return false;
     }
 
-    *sound = sysmem_push(sizeof(**sound));
+    *sound = sysmem_push(sizeof(**sound), SYSMEM_TAG_SOUNDS);
     if (!*sound)
     {
         return false;
@@ -818,7 +913,7 @@ static bool loadSound(const unsigned id)
     (*sound)->buf = NULL;
     (*sound)->dispose = true; /* sounds are "fire and forget" by default */
 
-    (*sound)->name = u_strdup(resourceFiles[id]);
+    (*sound)->name = u_strdup(resourceFiles[id], SYSMEM_TAG_SOUNDS);
     if (!(*sound)->name)
     {
         return false;
@@ -1089,9 +1184,9 @@ static bool readFile(const unsigned id)
             }
             case Resource_MARKS:
             {
-                vp = map_marks;
-                success = loadRawData(fp, &vp, sizeof(*map_marks), &map_nbr_marks);
-                map_marks = vp;
+                vp = map_marks_init;
+                success = loadRawData(fp, &vp, sizeof(*map_marks_init), &map_nbr_marks);
+                map_marks_init = vp;
                 break;
             }
             case Resource_EFLGC:
@@ -1232,9 +1327,9 @@ void resources_unload()
             }
             case Resource_MARKS:
             {
-                vp = map_marks;
+                vp = map_marks_init;
                 unloadRawData(&vp, &map_nbr_marks);
-                map_marks = vp;
+                map_marks_init = vp;
                 break;
             }
             case Resource_EFLGC:
@@ -28,10 +28,10 @@
 U8
 screen_gameover(void)
 {
-    static U8 seq = 0;
-    static U8 period = 0;
+#define seq (game_ctx->gameover.seq)
+#define period (game_ctx->gameover.period)
 #ifdef GFXST
-    static U32 tm = 0;
+#define tm (game_ctx->gameover.tm)
 #endif
     if (seq == 0) {
         draw_tilesBank = 0;
@@ -46,8 +46,8 @@ screen_gameover(void)
     switch (seq) {
     case 1:  /* display banner */
 #ifdef GFXST
-        sysvid_clear();
-        tm = sys_gettime();
+        draw_clear();
+        tm = game_time;
 #endif
         draw_tllst = screen_gameovertxt;
         draw_setfb(120, 80);
@@ -65,7 +65,7 @@ screen_gameover(void)
         if (control_test(Control_FIRE))
             seq = 3;
 #ifdef GFXST
-        else if (sys_gettime() - tm > SCREEN_TIMEOUT)
+        else if (game_time - tm > SCREEN_TIMEOUT)
             seq = 4;
 #endif
         break;
@@ -80,13 +80,16 @@ screen_gameover(void)
         return SCREEN_EXIT;
 
     if (seq == 4) {  /* we're done */
-        sysvid_clear();
+        draw_clear();
         seq = 0;
         game_period = period;
         return SCREEN_DONE;
     }
 
   return SCREEN_RUNNING;
+#undef seq
+#undef period
+#undef tm
 }
 
 /* eof */
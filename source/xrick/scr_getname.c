@@ -22,11 +22,13 @@
 #include "xrick/system/system.h"
 
 /*
- * local vars
+ * local vars (see context.h)
  */
-static U8 seq = 0;
-static U8 x, y, p;
-static U8 player_name[HISCORE_NAME_SIZE];
+#define seq (game_ctx->getname.seq)
+#define x (game_ctx->getname.x)
+#define y (game_ctx->getname.y)
+#define p (game_ctx->getname.p)
+#define player_name (game_ctx->getname.player_name)
 
 #define TILE_POINTER '\072'
 #define TILE_CURSOR '\073'
@@ -53,7 +55,7 @@ static void name_draw(void);
 U8
 screen_getname(void)
 {
-    static U32 tm = 0;
+#define tm (game_ctx->getname.tm)
     U8 i, j;
 
     if (seq == 0)
@@ -80,7 +82,7 @@ screen_getname(void)
     {
         case 1:  /* prepare screen */
         {
-            sysvid_clear();
+            draw_clear();
 #ifdef GFXPC
             draw_setfb(32, 8);
             draw_filter = 0xaaaa; /* red */
@@ -126,7 +128,7 @@ screen_getname(void)
                     pointer_show(false);
                     y--;
                     pointer_show(true);
-                    tm = sys_gettime();
+                    tm = game_time;
                 }
                 seq = 4;
             }
@@ -135,7 +137,7 @@ screen_getname(void)
                     pointer_show(false);
                     y++;
                     pointer_show(true);
-                    tm = sys_gettime();
+                    tm = game_time;
                 }
                 seq = 5;
             }
@@ -144,7 +146,7 @@ screen_getname(void)
                     pointer_show(false);
                     x--;
                     pointer_show(true);
-                    tm = sys_gettime();
+                    tm = game_time;
                 }
                 seq = 6;
             }
@@ -153,7 +155,7 @@ screen_getname(void)
                     pointer_show(false);
                     x++;
                     pointer_show(true);
-                    tm = sys_gettime();
+                    tm = game_time;
                 }
                 seq = 7;
             }
@@ -196,28 +198,28 @@ screen_getname(void)
         case 4:  /* wait for UP released */
         {
             if (!(control_test(Control_UP)) ||
-                sys_gettime() - tm > AUTOREPEAT_TMOUT)
+                game_time - tm > AUTOREPEAT_TMOUT)
                 seq = 2;
             break;
         }
         case 5:  /* wait for DOWN released */
         {
             if (!(control_test(Control_DOWN)) ||
-                sys_gettime() - tm > AUTOREPEAT_TMOUT)
+                game_time - tm > AUTOREPEAT_TMOUT)
                 seq = 2;
             break;
         }
         case 6:  /* wait for LEFT released */
         {
             if (!(control_test(Control_LEFT)) ||
-                sys_gettime() - tm > AUTOREPEAT_TMOUT)
+                game_time - tm > AUTOREPEAT_TMOUT)
                 seq = 2;
             break;
         }
         case 7:  /* wait for RIGHT released */
         {
             if (!(control_test(Control_RIGHT)) ||
-                sys_gettime() - tm > AUTOREPEAT_TMOUT)
+                game_time - tm > AUTOREPEAT_TMOUT)
                 seq = 2;
             break;
         }
@@ -227,12 +229,13 @@ screen_getname(void)
         return SCREEN_EXIT;
 
     if (seq == 99) {  /* seq 99, we're done */
-        sysvid_clear();
+        draw_clear();
         seq = 0;
         return SCREEN_DONE;
     }
     else
         return SCREEN_RUNNING;
+#undef tm
 }
 
 
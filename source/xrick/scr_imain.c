@@ -31,11 +31,11 @@
 U8
 screen_introMain(void)
 {
-    static U8 seq = 0;
-    static U8 seen = 0;
-    static bool first = true;
-    static U8 period = 0;
-    static U32 tm = 0;
+#define seq (game_ctx->imain.seq)
+#define seen (game_ctx->imain.seen)
+#define first (game_ctx->imain.first)
+#define period (game_ctx->imain.period)
+#define tm (game_ctx->imain.tm)
 
     if (seq == 0) {
         draw_tilesBank = 0;
@@ -55,8 +55,8 @@ screen_introMain(void)
     {
         case 1:  /* display Rick Dangerous title and Core Design copyright */
         {
-            sysvid_clear();
-            tm = sys_gettime();
+            draw_clear();
+            tm = game_time;
 #ifdef GFXPC
             /* Rick Dangerous title */
             draw_tllst = (U8 *)screen_imainrdt;
@@ -80,7 +80,7 @@ screen_introMain(void)
         {
             if (control_test(Control_FIRE))
                 seq = 3;
-            else if (sys_gettime() - tm > SCREEN_TIMEOUT) {
+            else if (game_time - tm > SCREEN_TIMEOUT) {
                 seen++;
                 seq = 4;
             }
@@ -101,8 +101,8 @@ screen_introMain(void)
             U8 s[32];
             size_t i;
 
-            sysvid_clear();
-            tm = sys_gettime();
+            draw_clear();
+            tm = game_time;
             /* hall of fame title */
 #ifdef GFXPC
             draw_tllst = (U8 *)screen_imainhoft;
@@ -134,7 +134,7 @@ screen_introMain(void)
         {
             if (control_test(Control_FIRE))
                 seq = 6;
-            else if (sys_gettime() - tm > SCREEN_TIMEOUT) {
+            else if (game_time - tm > SCREEN_TIMEOUT) {
                 seen++;
                 seq = 1;
             }
@@ -156,7 +156,7 @@ screen_introMain(void)
         return SCREEN_EXIT;
 
     if (seq == 7) {  /* we're done */
-        sysvid_clear();
+        draw_clear();
         seq = 0;
         seen = 0;
         first = false;
@@ -165,6 +165,11 @@ screen_introMain(void)
     }
     else
         return SCREEN_RUNNING;
+#undef seq
+#undef seen
+#undef first
+#undef period
+#undef tm
 }
 
 /* eof */
@@ -22,19 +22,22 @@
 #include "xrick/maps.h"
 
 /*
- * local vars
+ * local vars (see context.h)
  */
-static U16 step;              /* current step */
-static U16 count;             /* number of loops for current step */
-static U16 run;               /* 1 = run, 0 = no more step */
-static U8 flipflop;           /* flipflop for top, bottom, left, right */
-static U8 spnum;              /* sprite number */
-static U16 spx, spdx;         /* sprite x position and delta */
-static U16 spy, spdy;         /* sprite y position and delta */
-static U16 spbase, spoffs;    /* base, offset for sprite numbers table */
-static U8 seq = 0;            /* anim sequence */
-
-static rect_t anim_rect = { 128, 16 + 16, 64, 64, NULL }; /* anim rectangle */
+#define step (game_ctx->imap.step)          /* current step */
+#define loops (game_ctx->imap.loops)        /* number of loops for current step */
+#define run (game_ctx->imap.run)            /* 1 = run, 0 = no more step */
+#define flipflop (game_ctx->imap.flipflop)  /* flipflop for top, bottom, left, right */
+#define spnum (game_ctx->imap.spnum)        /* sprite number */
+#define spx (game_ctx->imap.spx)            /* sprite x position */
+#define spdx (game_ctx->imap.spdx)          /* sprite x delta */
+#define spy (game_ctx->imap.spy)            /* sprite y position */
+#define spdy (game_ctx->imap.spdy)          /* sprite y delta */
+#define spbase (game_ctx->imap.spbase)      /* base for sprite numbers table */
+#define spoffs (game_ctx->imap.spoffs)      /* offset for sprite numbers table */
+#define seq (game_ctx->imap.seq)            /* anim sequence */
+
+static const rect_t anim_rect = { 128, 16 + 16, 64, 64, NULL }; /* anim rectangle */
 
 /*
  * prototypes
@@ -59,7 +62,7 @@ screen_introMap(void)
 {
   switch (seq) {
   case 0:
-    sysvid_clear();
+    draw_clear();
 
 #ifdef GFXPC
     draw_tilesBank = 1;
@@ -132,7 +135,7 @@ screen_introMap(void)
     return SCREEN_EXIT;
 
   if (seq == 5) {  /* end as soon as key pressed */
-    sysvid_clear();
+    draw_clear();
     seq = 0;
     return SCREEN_DONE;
   }
@@ -236,7 +239,7 @@ static void
 nextstep(void)
 {
   if (screen_imapsteps[step].count) {
-    count = screen_imapsteps[step].count;
+    loops = screen_imapsteps[step].count;
     spdx = screen_imapsteps[step].dx;
     spdy = screen_imapsteps[step].dy;
     spbase = screen_imapsteps[step].base;
@@ -268,8 +271,8 @@ anim(void)
     spoffs++;
     spx += spdx;
     spy += spdy;
-    count--;
-    if (count == 0)
+    loops--;
+    if (loops == 0)
       nextstep();
   }
 }
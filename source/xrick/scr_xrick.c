@@ -37,7 +37,7 @@ size_t screen_nbr_imaptext = 0;
 U8 **screen_imaptext = NULL;
 
 size_t screen_nbr_hiscores = 0;
-hiscore_t *screen_highScores = NULL;
+hiscore_t *screen_highScores_init = NULL;
 
 #ifdef GFXPC
 U8 *screen_imainhoft = NULL;
@@ -57,11 +57,11 @@ U8 *screen_pausedtxt = NULL;
 U8
 screen_xrick(void)
 {
-    static U8 seq = 0;
-    static U8 wait = 0;
+#define seq (game_ctx->xrick.seq)
+#define wait (game_ctx->xrick.wait)
 
     if (seq == 0) {
-        sysvid_clear();
+        draw_clear();
         draw_img(img_splash);
         game_rects = &draw_SCREENRECT;
         seq = 1;
@@ -89,13 +89,15 @@ screen_xrick(void)
         return SCREEN_EXIT;
 
     if (seq == 99) {  /* we're done */
-        sysvid_clear();
+        draw_clear();
         sysvid_setGamePalette();
         seq = 0;
         return SCREEN_DONE;
     }
 
     return SCREEN_RUNNING;
+#undef seq
+#undef wait
 }
 
 /* eof */
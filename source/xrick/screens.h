@@ -51,7 +51,7 @@ extern size_t screen_nbr_imaptext;
 extern U8 **screen_imaptext;  /* map intro texts */
 
 extern size_t screen_nbr_hiscores;
-extern hiscore_t *screen_highScores;  /* highest scores (hall of fame) */
+extern hiscore_t *screen_highScores_init;  /* highest scores (hall of fame), as loaded, see context.h */
 
 #ifdef GFXPC
 extern U8 *screen_imainhoft;  /* hall of fame title */
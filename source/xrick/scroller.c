@@ -22,9 +22,9 @@
 #include "xrick/ents.h"
 
 /*
- * Local variables
+ * Local variables (see context.h)
  */
-static U8 period;
+#define period (game_ctx->scroll.period)
 
 /*
  * Scroll up
@@ -33,26 +33,24 @@ static U8 period;
 U8
 scroll_up(void)
 {
-  U8 i, j;
-  static U8 n = 0;
+  U8 i;
+#define phase (game_ctx->scroll.upPhase)
 
   /* last call: restore */
-  if (n == 8) {
-    n = 0;
+  if (phase == 8) {
+    phase = 0;
     game_period = period;
     return SCROLL_DONE;
   }
 
   /* first call: prepare */
-  if (n == 0) {
+  if (phase == 0) {
     period = game_period;
     game_period = SCROLL_PERIOD;
   }
 
   /* translate map */
-  for (i = MAP_ROW_SCRTOP; i < MAP_ROW_HBBOT; i++)
-    for (j = 0x00; j < 0x20; j++)
-      map_map[i][j] = map_map[i + 1][j];
+  map_rowBase++;
 
   /* translate entities */
   for (i = 0; ent_ents[i].n != 0xFF; i++) {
@@ -70,13 +68,14 @@ scroll_up(void)
   }
 
   /* display */
+  draw_scrollMap(true);
   draw_map();
   ent_draw();
   draw_drawStatus();
   map_frow++;
 
   /* loop */
-  if (n++ == 7) {
+  if (phase++ == 7) {
     /* activate visible entities */
     ent_actvis(map_frow + MAP_ROW_HBTOP, map_frow + MAP_ROW_HBBOT);
 
@@ -89,9 +88,10 @@ scroll_up(void)
     draw_drawStatus();
   }
 
-  game_rects = &draw_SCREENRECT;
+  game_rects = &draw_MAPRECT;  /* the whole map screen moved */
 
   return SCROLL_RUNNING;
+#undef phase
 }
 
 /*
@@ -101,26 +101,24 @@ scroll_up(void)
 U8
 scroll_down(void)
 {
-  U8 i, j;
-  static U8 n = 0;
+  U8 i;
+#define phase (game_ctx->scroll.downPhase)
 
   /* last call: restore */
-  if (n == 8) {
-    n = 0;
+  if (phase == 8) {
+    phase = 0;
     game_period = period;
     return SCROLL_DONE;
   }
 
   /* first call: prepare */
-  if (n == 0) {
+  if (phase == 0) {
     period = game_period;
     game_period = SCROLL_PERIOD;
   }
 
   /* translate map */
-  for (i = MAP_ROW_SCRBOT; i > MAP_ROW_HTTOP; i--)
-    for (j = 0x00; j < 0x20; j++)
-      map_map[i][j] = map_map[i - 1][j];
+  map_rowBase--;
 
   /* translate entities */
   for (i = 0; ent_ents[i].n != 0xFF; i++) {
@@ -138,13 +136,14 @@ scroll_down(void)
   }
 
   /* display */
+  draw_scrollMap(false);
   draw_map();
   ent_draw();
   draw_drawStatus();
   map_frow--;
 
   /* loop */
-  if (n++ == 7) {
+  if (phase++ == 7) {
     /* activate visible entities */
     ent_actvis(map_frow + MAP_ROW_HTTOP, map_frow + MAP_ROW_HTBOT);
 
@@ -157,9 +156,10 @@ scroll_down(void)
     draw_drawStatus();
   }
 
-  game_rects = &draw_SCREENRECT;
+  game_rects = &draw_MAPRECT;  /* the whole map screen moved */
 
   return SCROLL_RUNNING;
+#undef phase
 }
 
 /* eof */
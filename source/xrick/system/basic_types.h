@@ -43,6 +43,17 @@ typedef int8_t S8;    /*  8 bits signed   */
 typedef int16_t S16;  /* 16 bits signed   */
 typedef int32_t S32;  /* 32 bits signed   */
 
+/*
+ * thread local storage
+ */
+#if defined(ROCKBOX)
+#define THREAD_LOCAL  /* single threaded */
+#elif defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 #endif /* ndef _BASIC_TYPES_H */
 
 /* eof */
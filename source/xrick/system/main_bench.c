@@ -0,0 +1,432 @@
+/*
+ * xrick/system/main_bench.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Microbenchmarks of the rendering and simulation kernels (xrick_bench).
+ *
+ * Real resources are loaded and the first submap is set up, then each
+ * kernel is run in isolation: the number of iterations per batch is first
+ * doubled until a batch lasts at least MIN_BATCH_NS (which also warms
+ * caches up), then REPEATS batches are timed. Results are printed as CSV,
+ * one line per kernel, durations being per iteration, in nanoseconds:
+ *
+ *   kernel,variant,graphics,iterations,min_ns,median_ns,mean_ns
+ *
+ * Command-line options are those of xrick (e.g. --data, --nosound).
+ */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+#include "xrick/game.h"
+#include "xrick/draw.h"
+#include "xrick/maps.h"
+#include "xrick/util.h"
+#include "xrick/ents.h"
+#include "xrick/scroller.h"
+#include "xrick/data/sprites.h"
+#include "xrick/data/pics.h"
+#include "xrick/unpack.h"
+#if defined(ENABLE_SOUND) && !defined(ENABLE_NULL_SYSTEM)
+#include "xrick/system/syssnd_sdl.h"
+#endif
+
+#include <stdlib.h> /* qsort */
+
+enum
+{
+    MIN_BATCH_NS = 1000000,
+    REPEATS = 15
+};
+
+typedef void (*kernel_t)(U32);
+
+#ifdef GFXST
+static const char *graphics = "st";
+#endif
+#ifdef GFXPC
+static const char *graphics = "pc";
+#endif
+
+/*
+ * Local variables
+ */
+static game_ctx_t context;
+#if defined(ENABLE_SOUND) && !defined(ENABLE_NULL_SYSTEM)
+static U8 mixBuffer[SYSSND_MIXSAMPLES];
+#endif
+
+/*
+ * Kernels -- the argument is the iteration number, used to vary inputs
+ */
+static void
+benchTile(U32 i)
+{
+    draw_setfb((i & 0x1f) * 8, ((i >> 5) % 24) * 8);
+    draw_tile((U8)i);
+}
+
+static void
+benchSprite2(U32 i)
+{
+    draw_sprite2((U8)(i % sprites_nbr_sprites), 0x60, 0x90, false);
+}
+
+static void
+benchSprite2Clipped(U32 i)
+{
+    /* clipped at the top, and at the right every other time */
+    draw_sprite2((U8)(i % sprites_nbr_sprites), (i & 1) ? 0xe8 : 0x60, 0x38, false);
+}
+
+static void
+benchSpriteBackground(U32 i)
+{
+    /* the sprite drawn over the tiles, as in the game (includes a 3KB memset) */
+    draw_invalidate();
+    draw_spriteBackground(0x10 + (i * 13) % 0xd0, 0x40 + (i * 7) % 0xa0);
+}
+
+static void
+benchSpriteBackgroundClean(U32 i)
+{
+    /* tiles already there, nothing to copy */
+    draw_spriteBackground(0x10 + (i * 13) % 0xd0, 0x40 + (i * 7) % 0xa0);
+}
+
+#ifdef GFXST
+static void
+benchPic(U32 i)
+{
+    (void)i;
+    draw_pic(pic_splash);
+}
+#endif
+
+static void
+benchMap(U32 i)
+{
+    (void)i;
+    draw_invalidate();
+    draw_map();
+}
+
+static void
+benchMapUnchanged(U32 i)
+{
+    (void)i;
+    draw_map();
+}
+
+static void
+benchStatus(U32 i)
+{
+    (void)i;
+    draw_clearStatus();
+    draw_drawStatus();
+}
+
+static void
+benchStatusScore(U32 i)
+{
+    game_score = i;
+    draw_clearStatus();
+    draw_drawStatus();
+}
+
+static void
+benchMapExpand(U32 i)
+{
+    (void)i;
+    map_expand();
+}
+
+static void
+benchEnvtest(U32 i)
+{
+    U8 rc0, rc1;
+
+    u_envtest((S16)((i * 13) % 0xd8), (S16)(0x40 + (i * 7) % 0x90), i & 1, &rc0, &rc1);
+}
+
+static void
+benchScroll(U32 i)
+{
+    static bool down = false;
+    /* entities rectangles go on the context memory stack, and are released
+       with the frame, as in game_step */
+    sysmem_stack_t *stack = sysmem_setStack(&game_ctx->stack);
+
+    (void)i;
+    sysmem_release(&game_ctx->frameMark);
+    ent_rects = NULL;
+    /* scroll up a whole tile row, then back down */
+    if ((down ? scroll_down() : scroll_up()) == SCROLL_DONE)
+    {
+        down = !down;
+    }
+    sysmem_setStack(stack);
+}
+
+static U8 widenZoom;
+static U8 widenBuffer[SYSVID_WIDTH * SYSVID_MAXZOOM];
+static U32 widenLutBuffer[SYSVID_WIDTH * SYSVID_MAXZOOM];
+static U32 widenLut[256];
+
+static void
+benchWiden(U32 i)
+{
+    U16 y;
+
+    (void)i;
+    /* one frame worth of rows, as sysvid_update widens them */
+    for (y = 0; y < SYSVID_HEIGHT; y++)
+    {
+        unpack_widen(widenBuffer, game_ctx->framebuffer + y * SYSVID_WIDTH, SYSVID_WIDTH, widenZoom);
+    }
+}
+
+static void
+benchWidenLut(U32 i)
+{
+    U16 y;
+
+    (void)i;
+    for (y = 0; y < SYSVID_HEIGHT; y++)
+    {
+        unpack_widenLut(widenLutBuffer, game_ctx->framebuffer + y * SYSVID_WIDTH, SYSVID_WIDTH, widenZoom, widenLut);
+    }
+}
+
+static void
+benchVideo(U32 i)
+{
+    (void)i;
+    sysvid_update(&draw_SCREENRECT);
+}
+
+#if defined(ENABLE_SOUND) && !defined(ENABLE_NULL_SYSTEM)
+static void
+benchMixer(U32 i)
+{
+    (void)i;
+    syssnd_callback(NULL, mixBuffer, sizeof(mixBuffer));
+}
+#endif
+
+/*
+ * Compare durations, for qsort
+ */
+static int
+compareDurations(const void *a, const void *b)
+{
+    U32 da = *(const U32 *)a;
+    U32 db = *(const U32 *)b;
+
+    return (da > db) - (da < db);
+}
+
+/*
+ * Time a batch of iterations, in nanoseconds
+ */
+static U32
+timeBatch(kernel_t kernel, U32 iterations)
+{
+    U32 t0 = sysprof_time();
+    U32 i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        kernel(i);
+    }
+    return sysprof_time() - t0;
+}
+
+/*
+ * Benchmark a kernel and print its results
+ */
+static void
+bench(const char *name, const char *variant, kernel_t kernel)
+{
+    U32 durations[REPEATS];
+    U32 iterations = 1;
+    double sum = 0;
+    U32 r;
+
+    /* calibrate (and warm up) */
+    while (timeBatch(kernel, iterations) < MIN_BATCH_NS && iterations < (1u << 24))
+    {
+        iterations *= 2;
+    }
+
+    for (r = 0; r < REPEATS; r++)
+    {
+        durations[r] = timeBatch(kernel, iterations);
+        sum += durations[r];
+    }
+    qsort(durations, REPEATS, sizeof(U32), compareDurations);
+
+    sys_printf("%s,%s,%s,%u,%.1f,%.1f,%.1f\n", name, variant, graphics, iterations,
+               (double)durations[0] / iterations,
+               (double)durations[REPEATS / 2] / iterations,
+               sum / REPEATS / iterations);
+}
+
+/*
+ * Benchmark the upscaling kernels, at each zoom level
+ */
+static void
+benchWidenZooms(void)
+{
+    char variant[16];
+    U16 c;
+
+    for (c = 0; c < 256; c++)
+    {
+        widenLut[c] = 0xff000000 | (c * 0x010101);
+    }
+    for (widenZoom = 1; widenZoom <= SYSVID_MAXZOOM; widenZoom++)
+    {
+        unpack_widen(widenBuffer, widenBuffer, 0, widenZoom);  /* pick the kernels */
+        sys_snprintf(variant, sizeof(variant), "x%u %s", widenZoom, unpack_kernels);
+        bench("unpack_widen", variant, benchWiden);
+        bench("unpack_widenLut", variant, benchWidenLut);
+    }
+}
+
+/*
+ * Benchmark sysvid_update, at each zoom level when there is one
+ */
+static void
+benchVideoZooms(void)
+{
+#ifdef ENABLE_NULL_SYSTEM
+    bench("sysvid_update", "null", benchVideo);
+    sysvid_frames = 0;  /* these are no game frames, keep them out of the summary */
+#else
+    char variant[8];
+    U8 zoom;
+
+    for (zoom = 1; zoom < SYSVID_MAXZOOM; zoom++)
+    {
+        sysvid_zoom(-1);
+    }
+    for (zoom = 1; zoom <= SYSVID_MAXZOOM; zoom++)
+    {
+        sys_snprintf(variant, sizeof(variant), "x%u", zoom);
+        bench("sysvid_update", variant, benchVideo);
+        sysvid_zoom(+1);
+    }
+#endif
+}
+
+/*
+ * Benchmark the mixer, with all channels active
+ */
+#if defined(ENABLE_SOUND) && !defined(ENABLE_NULL_SYSTEM)
+static void
+benchMixerChannels(void)
+{
+    sound_t *sounds[SYSSND_MIXCHANNELS];
+    U8 c;
+
+    if (sysarg_args_nosound)
+    {
+        return;
+    }
+
+    sounds[0] = soundBombshht;
+    sounds[1] = soundBonus;
+    sounds[2] = soundBox;
+    sounds[3] = soundBullet;
+    sounds[4] = soundCrawl;
+    sounds[5] = soundDie;
+    sounds[6] = soundExplode;
+    sounds[7] = soundJump;
+    for (c = 0; c < SYSSND_MIXCHANNELS; c++)
+    {
+        syssnd_play(sounds[c], -1);
+    }
+    /* the audio thread must not mix at the same time */
+    syssnd_pauseAll(true);
+
+    bench("syssnd_callback", "8ch", benchMixer);
+
+    syssnd_stopAll();
+    syssnd_pauseAll(false);
+}
+#endif
+
+/*
+ * main
+ */
+int
+main(int argc, char *argv[])
+{
+    game_ctx_t *previous;
+    bool success = sys_init(argc, argv) && game_loadData();
+
+    if (success && !game_initContext(&context, sysvid_fb))
+    {
+        game_unloadData();
+        success = false;
+    }
+
+    if (success)
+    {
+        previous = game_setContext(&context);
+
+        /* first submap of first map */
+        game_map = 0;
+        game_submap = map_maps[0].submap;
+        map_frow = (U8)map_maps[0].row;
+        ent_ents[ENT_ENTSNUM].n = 0xff;  /* end of entities marker */
+        map_init();
+        draw_tilesBank = map_tilesBank;
+        sysvid_setGamePalette();
+
+        sys_printf("kernel,variant,graphics,iterations,min_ns,median_ns,mean_ns\n");
+        bench("draw_tile", "-", benchTile);
+        bench("draw_sprite2", "visible", benchSprite2);
+        bench("draw_sprite2", "clipped", benchSprite2Clipped);
+        bench("draw_spriteBackground", "dirty", benchSpriteBackground);
+        bench("draw_spriteBackground", "clean", benchSpriteBackgroundClean);
+#ifdef GFXST
+        bench("draw_pic", unpack_kernels, benchPic);
+#endif
+        bench("draw_map", "full", benchMap);
+        bench("draw_map", "unchanged", benchMapUnchanged);
+        game_lives = game_bullets = game_bombs = 6;
+        bench("draw_drawStatus", "unchanged", benchStatus);
+        bench("draw_drawStatus", "score", benchStatusScore);
+        bench("map_expand", "-", benchMapExpand);
+        bench("u_envtest", "-", benchEnvtest);
+        bench("scroll", "step", benchScroll);
+        benchWidenZooms();
+        benchVideoZooms();
+#if defined(ENABLE_SOUND) && !defined(ENABLE_NULL_SYSTEM)
+        benchMixerChannels();
+#endif
+
+        game_setContext(previous);
+        game_freeContext(&context);
+        game_unloadData();
+    }
+    sys_shutdown();
+    return (success? 0 : 1);
+}
+
+/* eof */
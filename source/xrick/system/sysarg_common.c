@@ -0,0 +1,302 @@
+/*
+ * xrick/system/sysarg_common.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+#include "xrick/system/sysarg_common.h"
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+#include "xrick/game.h"
+
+#include <stdlib.h>  /* atoi */
+#include <string.h>  /* strcmp */
+
+#ifdef ENABLE_NULL_SYSTEM
+#define SYSARG_TURBO_MIN 1  /* no adaptive mode, time is simulated */
+#else
+#define SYSARG_TURBO_MIN 0
+#endif
+
+int sysarg_args_period = 0;
+int sysarg_args_turbo = 1;
+int sysarg_args_map = 0;
+int sysarg_args_submap = 0;
+int sysarg_args_memory = 0;
+const char *sysarg_args_data = NULL;
+#ifdef ENABLE_REPLAY
+const char *sysarg_args_record = NULL;
+const char *sysarg_args_replay = NULL;
+#endif /* ENABLE_REPLAY */
+#ifdef ENABLE_OBSERVE
+const char *sysarg_args_observe = NULL;
+#endif /* ENABLE_OBSERVE */
+
+/*
+ * Version info
+ */
+static void sysarg_version(void)
+{
+    sys_printf(
+#ifdef ENABLE_NULL_SYSTEM
+        "xrick version '%s' (null system)\n\n"
+#else
+        "xrick version '%s'\n\n"
+#endif
+        " Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).\n"
+        " Copyright (C) 2008-2014 Pierluigi Vicinanza.\n"
+        " All rights reserved.\n\n"
+        " The use and distribution terms for this software are contained in the file\n"
+        " named README, which can be found in the root of this distribution. By\n"
+        " using this software in any fashion, you are agreeing to be bound by the\n"
+        " terms of this license.\n\n", XRICK_VERSION_STR);
+}
+
+/*
+ * Help on shared options, printed after the system specific ones
+ */
+void sysarg_helpCommon(void)
+{
+   sys_printf(
+       "  --speed <speed>    Run at speed <speed>. <speed> must be \n"
+       "                     an integer between 1 (fast) and 100 (slow).\n"
+#ifdef ENABLE_NULL_SYSTEM
+       "                     The default is %d. Only affects simulated time.\n"
+       "  --turbo <steps>    Run <steps> game steps for each frame displayed.\n"
+#else
+       "                     The default is %d.\n"
+       "  --turbo <steps>    Run <steps> game steps for each frame displayed,\n"
+       "                     i.e. <steps> times faster. 0 means as fast as\n"
+       "                     possible, still displaying at normal speed.\n"
+#endif
+       "                     The default is 1.\n"
+       "  --map <map>        Start at map number <map>.\n"
+       "                     <map> must be an integer between 1 and %d.\n"
+       "                     The default is to start at map number 1.\n"
+       "  --submap <submap>  Start at submap <submap>.\n"
+       "                     <submap> must be an integer between 1 and %d.\n"
+       "                     The default is to start at submap number 1\n"
+       "                     or, if a map was specified,\n"
+       "                     at the first submap of that map.\n"
+       "  --data <archive>   Use data archive <archive>\n"
+       "                     <archive> must be either a zip file or\n"
+       "                     a directory. The default is to look for \"data.zip\"\n"
+       "                     in the directory where xrick is run from.\n"
+       "  --memory <size>    Use a <size> KB memory stack for game data.\n"
+       "                     <size> must be an integer between %d and 1048576.\n"
+       "                     The default is %d.\n"
+#ifdef ENABLE_REPLAY
+       "  --record <file>    Record controls to <file>.\n"
+       "  --replay <file>    Replay controls recorded in <file>, as fast\n"
+       "                     as possible, then exit.\n"
+#endif /* ENABLE_REPLAY */
+#ifdef ENABLE_OBSERVE
+       "  --observe <name>   Publish frames to shared memory object <name>\n"
+       "                     (e.g. /xrick), for other processes to read.\n"
+#endif /* ENABLE_OBSERVE */
+       "  --version          Print version information.\n\n",
+       GAME_PERIOD, SYSARG_NBR_MAPS, SYSARG_NBR_SUBMAPS,
+       SYSMEM_STACK_MIN_SIZE / 1024, SYSMEM_STACK_SIZE / 1024);
+}
+
+/*
+ * Fail
+ */
+void sysarg_fail(const char *msg)
+{
+    sys_printf(
+        "xrick: %s\n"
+        " Use 'xrick --help' for a complete list of options.\n", msg);
+}
+
+/*
+ * Read a shared option, once the system specific options did not match
+ *
+ * i: index of the option in argv CHANGED to the index of its value, if any
+ * return: false if the option is invalid or unknown, or if xrick
+ *         has to exit (--version)
+ */
+bool
+sysarg_parseCommon(int argc, char **argv, int *i)
+{
+    if (!strcmp(argv[*i], "--speed"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing speed value");
+            return false;
+        }
+        sysarg_args_period = atoi(argv[*i]) - 1;
+        if (sysarg_args_period < 0 || sysarg_args_period > 99)
+        {
+            sysarg_fail("invalid speed value");
+            return false;
+        }
+    }
+    else if (!strcmp(argv[*i], "--turbo"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing turbo steps");
+            return false;
+        }
+        sysarg_args_turbo = atoi(argv[*i]);
+        if (sysarg_args_turbo < SYSARG_TURBO_MIN || sysarg_args_turbo > 100)
+        {
+            sysarg_fail("invalid turbo steps");
+            return false;
+        }
+    }
+    else if (!strcmp(argv[*i], "--map"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing map number");
+            return false;
+        }
+        sysarg_args_map = atoi(argv[*i]) - 1;
+        if (sysarg_args_map < 0 || sysarg_args_map >= SYSARG_NBR_MAPS)
+        {
+            sysarg_fail("invalid map number");
+            return false;
+        }
+    }
+    else if (!strcmp(argv[*i], "--submap"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing submap number");
+            return false;
+        }
+        sysarg_args_submap = atoi(argv[*i]) - 1;
+        if (sysarg_args_submap < 0 || sysarg_args_submap >= SYSARG_NBR_SUBMAPS)
+        {
+            sysarg_fail("invalid submap number");
+            return false;
+        }
+    }
+    else if (!strcmp(argv[*i], "--data"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing data");
+            return false;
+        }
+        sysarg_args_data = argv[*i];
+    }
+    else if (!strcmp(argv[*i], "--memory"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing memory size");
+            return false;
+        }
+        sysarg_args_memory = atoi(argv[*i]);
+        if (sysarg_args_memory < SYSMEM_STACK_MIN_SIZE / 1024 || sysarg_args_memory > 1048576)
+        {
+            sysarg_fail("invalid memory size");
+            return false;
+        }
+    }
+#ifdef ENABLE_REPLAY
+    else if (!strcmp(argv[*i], "--record"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing record file");
+            return false;
+        }
+        sysarg_args_record = argv[*i];
+    }
+    else if (!strcmp(argv[*i], "--replay"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing replay file");
+            return false;
+        }
+        sysarg_args_replay = argv[*i];
+    }
+#endif /* ENABLE_REPLAY */
+#ifdef ENABLE_OBSERVE
+    else if (!strcmp(argv[*i], "--observe"))
+    {
+        if (++*i == argc)
+        {
+            sysarg_fail("missing shared memory name");
+            return false;
+        }
+        sysarg_args_observe = argv[*i];
+    }
+#endif /* ENABLE_OBSERVE */
+    else if (!strcmp(argv[*i], "--version"))
+    {
+        sysarg_version();
+        return false;
+    }
+    else
+    {
+        char message[128];
+        sys_snprintf(message, sizeof(message), "unrecognized option '%s'", argv[*i]);
+        sysarg_fail(message);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Check shared options against each other, once all arguments are read
+ */
+bool
+sysarg_checkCommon(void)
+{
+#ifdef ENABLE_REPLAY
+    if (sysarg_args_record && sysarg_args_replay)
+    {
+        sysarg_fail("can not record and replay at the same time");
+        return false;
+    }
+#endif /* ENABLE_REPLAY */
+
+    /* TODO: remove checks below based on hardcoded values.
+    *       Add code to check sysarg_args_map and sysarg_args_submap against map/submap max counts
+    *       (after these have been loaded from resource files).
+    */
+
+    /* this is dirty (sort of) */
+    if (sysarg_args_submap > 0 && sysarg_args_submap < 9)
+    {
+        sysarg_args_map = 0;
+    }
+    if (sysarg_args_submap >= 9 && sysarg_args_submap < 20)
+    {
+        sysarg_args_map = 1;
+    }
+    if (sysarg_args_submap >= 20 && sysarg_args_submap < 38)
+    {
+        sysarg_args_map = 2;
+    }
+    if (sysarg_args_submap >= 38)
+    {
+        sysarg_args_map = 3;
+    }
+    if (sysarg_args_submap == 9 ||
+        sysarg_args_submap == 20 ||
+        sysarg_args_submap == 38)
+    {
+        sysarg_args_submap = 0;
+    }
+    return true;
+}
+
+/* eof */
@@ -0,0 +1,32 @@
+/*
+ * xrick/system/sysarg_common.h
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+#ifndef _SYSARG_COMMON_H
+#define _SYSARG_COMMON_H
+
+#include "xrick/system/basic_types.h"
+
+/*
+ * Options shared by the SDL and null argument parsers. Each parser reads
+ * its own options and hands any other one to sysarg_parseCommon.
+ */
+extern void sysarg_fail(const char *);
+extern void sysarg_helpCommon(void);
+extern bool sysarg_parseCommon(int, char **, int *);
+extern bool sysarg_checkCommon(void);
+
+#endif /* ndef _SYSARG_COMMON_H */
+
+/* eof */
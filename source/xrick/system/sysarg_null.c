@@ -0,0 +1,158 @@
+/*
+ * xrick/system/sysarg_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+
+#include "xrick/system/sysarg_common.h"
+
+#include <stdlib.h>  /* atoi */
+#include <string.h>  /* strcmp */
+
+int sysarg_args_fullscreen = 0;
+int sysarg_args_zoom = 0;
+int sysarg_args_depth = 0;
+#ifdef ENABLE_SOUND
+bool sysarg_args_nosound = false;
+int sysarg_args_vol = 0;
+#endif /* ENABLE_SOUND */
+U32 sysarg_args_frames = 0;
+#ifdef ENABLE_BATCH
+U32 sysarg_args_batch = 0;
+U32 sysarg_args_threads = 0;
+#endif /* ENABLE_BATCH */
+
+/*
+ * Help
+ */
+static void sysarg_help(void)
+{
+   sys_printf(
+       "Usage: xrick [option(s)]\n"
+       " The options are:\n\n"
+       "  -h, --help         Display this information\n"
+       "  --frames <frames>  Exit after <frames> frames.\n"
+       "                     The default is to run until the game exits.\n"
+#ifdef ENABLE_BATCH
+       "  --batch <games>    Run <games> games side by side, with random\n"
+       "                     controls, for the number of frames given\n"
+       "                     by --frames, then print throughput.\n"
+       "  --threads <n>      Run batch games on <n> threads. The default\n"
+       "                     is one thread per processor.\n"
+#endif /* ENABLE_BATCH */
+       );
+   sysarg_helpCommon();
+}
+
+/*
+ * Read and process arguments
+ */
+bool
+sysarg_init(int argc, char **argv)
+{
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--help") ||
+            !strcmp(argv[i], "-h"))
+        {
+            sysarg_help();
+            return false;
+        }
+        else if (!strcmp(argv[i], "--frames"))
+        {
+            if (++i == argc)
+            {
+                sysarg_fail("missing frames count");
+                return false;
+            }
+            if (atoi(argv[i]) < 1)
+            {
+                sysarg_fail("invalid frames count");
+                return false;
+            }
+            sysarg_args_frames = atoi(argv[i]);
+        }
+#ifdef ENABLE_BATCH
+        else if (!strcmp(argv[i], "--batch"))
+        {
+            if (++i == argc)
+            {
+                sysarg_fail("missing games count");
+                return false;
+            }
+            if (atoi(argv[i]) < 1)
+            {
+                sysarg_fail("invalid games count");
+                return false;
+            }
+            sysarg_args_batch = atoi(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--threads"))
+        {
+            if (++i == argc)
+            {
+                sysarg_fail("missing threads count");
+                return false;
+            }
+            if (atoi(argv[i]) < 1)
+            {
+                sysarg_fail("invalid threads count");
+                return false;
+            }
+            sysarg_args_threads = atoi(argv[i]);
+        }
+#endif /* ENABLE_BATCH */
+        else if (!sysarg_parseCommon(argc, argv, &i))
+        {
+            return false;
+        }
+    }
+
+    if (!sysarg_checkCommon())
+    {
+        return false;
+    }
+
+#ifdef ENABLE_BATCH
+    if (sysarg_args_batch)
+    {
+        if (!sysarg_args_frames)
+        {
+            sysarg_fail("batch games need a frames count");
+            return false;
+        }
+#ifdef ENABLE_REPLAY
+        if (sysarg_args_record || sysarg_args_replay)
+        {
+            sysarg_fail("can not record or replay batch games");
+            return false;
+        }
+#endif /* ENABLE_REPLAY */
+#ifdef ENABLE_OBSERVE
+        if (sysarg_args_observe)
+        {
+            sysarg_fail("can not observe batch games");
+            return false;
+        }
+#endif /* ENABLE_OBSERVE */
+    }
+#endif /* ENABLE_BATCH */
+
+    return true;
+}
+
+/* eof */
@@ -28,6 +28,7 @@
  * globals
  */
 int sysarg_args_period = 0; /* time between each frame, in milliseconds. The default is 40. */
+int sysarg_args_turbo = 1; /* game steps per frame displayed */
 int sysarg_args_map = 0;
 int sysarg_args_submap = 0;
 bool sysarg_args_nosound = false;
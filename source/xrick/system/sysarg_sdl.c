@@ -19,9 +19,8 @@
 
 #include "xrick/system/system.h"
 #include "xrick/config.h"
-#include "xrick/game.h"
 
-#include "xrick/maps.h"
+#include "xrick/system/sysarg_common.h"
 #include "xrick/system/syssnd_sdl.h"
 
 #include <stdlib.h>  /* atoi */
@@ -43,30 +42,11 @@ static sdlcodes_t sdlcodes[SDLK_LAST] = {
 #include "xrick/system/sdl_codes.e"
 };
 
-int sysarg_args_period = 0;
-int sysarg_args_map = 0;
-int sysarg_args_submap = 0;
 int sysarg_args_fullscreen = 0;
 int sysarg_args_zoom = 0;
+int sysarg_args_depth = 0;
 bool sysarg_args_nosound = false;
 int sysarg_args_vol = 0;
-const char *sysarg_args_data = NULL;
-
-/*
- * Version info
- */
-static void sysarg_version(void)
-{
-    sys_printf(
-        "xrick version '%s'\n\n"
-        " Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).\n"
-        " Copyright (C) 2008-2014 Pierluigi Vicinanza.\n"
-        " All rights reserved.\n\n"
-        " The use and distribution terms for this software are contained in the file\n"
-        " named README, which can be found in the root of this distribution. By\n"
-        " using this software in any fashion, you are agreeing to be bound by the\n"
-        " terms of this license.\n\n", XRICK_VERSION_STR);
-}
 
 /*
  * Help
@@ -79,27 +59,15 @@ static void sysarg_help(void)
        "  -h, --help         Display this information\n"
        "  --fullscreen       Run in fullscreen mode.\n"
        "                     The default is to run in a window.\n"
-       "  --speed <speed>    Run at speed <speed>. <speed> must be \n"
-       "                     an integer between 1 (fast) and 100 (slow).\n"
-       "                     The default is %d.\n"
        "  --zoom <zoom>      Display with zoom factor <zoom>.\n"
        "                     <zoom> must be an integer between 1 (320x200)\n"
        "                     and %d (%d times bigger). The default is %d.\n"
-       "  --map <map>        Start at map number <map>.\n"
-       "                     <map> must be an integer between 1 and %d.\n"
-       "                     The default is to start at map number 1.\n"
-       "  --submap <submap>  Start at submap <submap>.\n"
-       "                     <submap> must be an integer between 1 and %d.\n"
-       "                     The default is to start at submap number 1\n"
-       "                     or, if a map was specified,\n"
-       "                     at the first submap of that map.\n"
+       "  --depth <depth>    Display with <depth> bits per pixel: 8 (palette)\n"
+       "                     or 32. The default is 32 when the display is\n"
+       "                     32 bits deep, 8 otherwise.\n"
        "  --keys <left>-<right>-<up>-<down>-<fire>\n"
        "                     Override the default key bindings\n"
        "                     (cf. KeyCodes).\n"
-       "  --data <archive>   Use data archive <archive>\n"
-       "                     <archive> must be either a zip file or\n"
-       "                     a directory. The default is to look for \"data.zip\"\n"
-       "                     in the directory where xrick is run from.\n"
 #ifdef ENABLE_SOUND
        "  --nosound          Disable sounds.\n"
        "                     The default is to play with sounds enabled.\n"
@@ -108,23 +76,12 @@ static void sysarg_help(void)
        "                     and %d (max). The default is to play sounds\n"
        "                     at maximum volume (%d).\n"
 #endif /* ENABLE_SOUND */
-       "  --version          Print version information.\n\n",
-       GAME_PERIOD, SYSVID_MAXZOOM, SYSVID_MAXZOOM, SYSVID_ZOOM, 5/*MAP_NBR_MAPS*/-1, 47/*MAP_NBR_SUBMAPS*/
+       , SYSVID_MAXZOOM, SYSVID_MAXZOOM, SYSVID_ZOOM
 #ifdef ENABLE_SOUND
        , SYSSND_MAXVOL, SYSSND_MAXVOL
 #endif /* ENABLE_SOUND */
        );
-   /* TODO: remove hardcoded map/submap max counts because they are now loaded from resource files */
-}
-
-/*
- * Fail
- */
-static void sysarg_fail(char *msg)
-{
-    sys_printf(
-        "xrick: %s\n"
-        " Use 'xrick --help' for a complete list of options.\n", msg);
+   sysarg_helpCommon();
 }
 
 /*
@@ -216,20 +173,6 @@ sysarg_init(int argc, char **argv)
             sysarg_help();
             return false;
         }
-        else if (!strcmp(argv[i], "--speed"))
-        {
-            if (++i == argc)
-            {
-                sysarg_fail("missing speed value");
-                return false;
-            }
-            sysarg_args_period = atoi(argv[i]) - 1;
-            if (sysarg_args_period < 0 || sysarg_args_period > 99)
-            {
-                sysarg_fail("invalid speed value");
-                return false;
-            }
-        }
         else if (!strcmp(argv[i], "--keys"))
         {
             if (++i == argc)
@@ -257,31 +200,17 @@ sysarg_init(int argc, char **argv)
                 return false;
             }
         }
-        else if (!strcmp(argv[i], "--map"))
+        else if (!strcmp(argv[i], "--depth"))
         {
             if (++i == argc)
             {
-                sysarg_fail("missing map number");
+                sysarg_fail("missing depth value");
                 return false;
             }
-            sysarg_args_map = atoi(argv[i]) - 1;
-            if (sysarg_args_map < 0 || sysarg_args_map >= 5/*MAP_NBR_MAPS*/-1) /* TODO: remove hardcoded map max count */
+            sysarg_args_depth = atoi(argv[i]);
+            if (sysarg_args_depth != 8 && sysarg_args_depth != 32)
             {
-                sysarg_fail("invalid map number");
-                return false;
-            }
-        }
-        else if (!strcmp(argv[i], "--submap"))
-        {
-            if (++i == argc)
-            {
-                sysarg_fail("missing submap number");
-                return false;
-            }
-            sysarg_args_submap = atoi(argv[i]) - 1;
-            if (sysarg_args_submap < 0 || sysarg_args_submap >= 47/*MAP_NBR_SUBMAPS*/) /* TODO: remove hardcoded submap max count */
-            {
-                sysarg_fail("invalid submap number");
+                sysarg_fail("invalid depth value");
                 return false;
             }
         }
@@ -305,63 +234,13 @@ sysarg_init(int argc, char **argv)
             sysarg_args_nosound = true;
         }
 #endif /* ENABLE_SOUND */
-        else if (!strcmp(argv[i], "--data"))
-        {
-            if (++i == argc)
-            {
-                sysarg_fail("missing data");
-                return false;
-            }
-            sysarg_args_data = argv[i];
-        }
-        else if (!strcmp(argv[i], "--version"))
+        else if (!sysarg_parseCommon(argc, argv, &i))
         {
-            sysarg_version();
-            return false;
-        }
-        else
-        {
-            char message[128];
-            sys_snprintf(message, sizeof(message), "unrecognized option '%s'", argv[i]);
-            sysarg_fail(message);
             return false;
         }
     }
 
-    /* TODO: remove checks below based on hardcoded values.
-    *       Add code to check sysarg_args_map and sysarg_args_submap against map/submap max counts
-    *       (after these have been loaded from resource files).
-    */
-
-    /* this is dirty (sort of) */
-    if (sysarg_args_submap > 0 && sysarg_args_submap < 9)
-    {
-        sysarg_args_map = 0;
-    }
-    if (sysarg_args_submap >= 9 && sysarg_args_submap < 20)
-    {
-        sysarg_args_map = 1;
-    }
-    if (sysarg_args_submap >= 20 && sysarg_args_submap < 38)
-    {
-        sysarg_args_map = 2;
-    }
-    if (sysarg_args_submap >= 38)
-    {
-        sysarg_args_map = 3;
-    }
-    if (sysarg_args_submap == 9 ||
-        sysarg_args_submap == 20 ||
-        sysarg_args_submap == 38)
-    {
-        sysarg_args_submap = 0;
-    }
-    return true;
+    return sysarg_checkCommon();
 }
 
 /* eof */
-
-
-
-
-
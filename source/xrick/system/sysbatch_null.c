@@ -0,0 +1,250 @@
+/*
+ * xrick/system/sysbatch_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Batch runner: steps many independent games side by side, one context
+ * each, on the thread pool.
+ *
+ * All games draw into one array of frame buffers (sysbatch_fbs), and after
+ * each frame their entity tables are gathered into one array
+ * (sysbatch_ents), so that observing the whole batch means walking two
+ * contiguous arrays.
+ *
+ * There is no player: each game is fed random controls, from a generator
+ * seeded with the game number. Games are thus reproducible whatever the
+ * number of threads, which the final checksum allows to verify.
+ */
+
+#define _POSIX_C_SOURCE 200112L  /* clock_gettime */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+
+#ifdef ENABLE_BATCH
+
+#include "xrick/game.h"
+#include "xrick/control.h"
+#include "xrick/ents.h"
+
+#include <stdlib.h> /* malloc */
+#include <string.h> /* memcpy */
+#include <time.h>   /* clock_gettime */
+
+enum
+{
+    FB_SIZE = SYSVID_WIDTH * SYSVID_HEIGHT,
+    ENTS_SIZE = ENT_ENTSNUM + 1,
+    MAX_HOLD = 32  /* max number of frames controls are held */
+};
+
+typedef struct {
+    game_ctx_t context;
+    U32 seed;    /* random controls generator */
+    U8 status;   /* current controls */
+    U8 hold;     /* frames left before changing controls */
+    bool over;   /* game has exited */
+} game_t;
+
+/* plausible controls, i.e. no pause, end or exit */
+static const U8 controls[] = {
+    0,
+    Control_LEFT, Control_RIGHT, Control_UP, Control_DOWN, Control_FIRE,
+    Control_UP | Control_LEFT, Control_UP | Control_RIGHT,
+    Control_FIRE | Control_LEFT, Control_FIRE | Control_RIGHT,
+    Control_FIRE | Control_UP, Control_FIRE | Control_DOWN
+};
+
+/*
+ * Global variables
+ */
+U32 sysbatch_games = 0;
+U8 *sysbatch_fbs = NULL;
+ent_t *sysbatch_ents = NULL;
+
+/*
+ * Local variables
+ */
+static game_t *games = NULL;
+
+/*
+ * Wall-clock time, in seconds
+ */
+static double
+now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Pick the controls of a game for next frame
+ */
+static void
+randomControls(game_t *game)
+{
+    if (game->hold == 0)
+    {
+        game->seed = game->seed * 1103515245 + 12345;
+        game->status = controls[(game->seed >> 16) % sizeof(controls)];
+        game->hold = 1 + (game->seed >> 8) % MAX_HOLD;
+    }
+    game->hold--;
+    control_status = game->status;
+}
+
+/*
+ * Step one game by one frame (pool task)
+ */
+static void
+stepGame(void *data, U32 index)
+{
+    game_t *game = &games[index];
+    game_ctx_t *previous;
+
+    (void)data;
+    if (game->over)
+    {
+        return;
+    }
+
+    previous = game_setContext(&game->context);
+    randomControls(game);
+    game->over = !game_step();
+    memcpy(sysbatch_ents + index * ENTS_SIZE, ent_ents, ENTS_SIZE * sizeof(ent_t));
+    game_setContext(previous);
+}
+
+/*
+ * Checksum (FNV-1a) of all frame buffers and scores
+ */
+static U32
+checksum(void)
+{
+    U32 h = 2166136261u;
+    size_t i;
+    U32 k;
+
+    for (i = 0; i < (size_t)sysbatch_games * FB_SIZE; i++)
+    {
+        h = (h ^ sysbatch_fbs[i]) * 16777619u;
+    }
+    for (k = 0; k < sysbatch_games; k++)
+    {
+        game_ctx_t *previous = game_setContext(&games[k].context);
+        h = (h ^ game_score) * 16777619u;
+        game_setContext(previous);
+    }
+    return h;
+}
+
+/*
+ * Release games
+ */
+static void
+freeGames(U32 count)
+{
+    while (count--)
+    {
+        game_freeContext(&games[count].context);
+    }
+    free(sysbatch_ents);
+    sysbatch_ents = NULL;
+    free(sysbatch_fbs);
+    sysbatch_fbs = NULL;
+    free(games);
+    games = NULL;
+    sysbatch_games = 0;
+}
+
+/*
+ * Run sysarg_args_batch games for sysarg_args_frames frames
+ */
+void
+sysbatch_run(void)
+{
+    U32 count = sysarg_args_batch;
+    U32 frame;
+    U32 i;
+    double start, seconds;
+
+    if (!game_loadData())
+    {
+        return;
+    }
+
+    games = malloc(count * sizeof(*games));
+    sysbatch_fbs = malloc((size_t)count * FB_SIZE);
+    sysbatch_ents = malloc((size_t)count * ENTS_SIZE * sizeof(ent_t));
+    if (!games || !sysbatch_fbs || !sysbatch_ents)
+    {
+        sys_error("(batch) malloc failed");
+        freeGames(0);
+        game_unloadData();
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        game_ctx_t *previous;
+
+        if (!game_initContext(&games[i].context, sysbatch_fbs + (size_t)i * FB_SIZE))
+        {
+            freeGames(i + 1);
+            game_unloadData();
+            return;
+        }
+        previous = game_setContext(&games[i].context);
+        e_them_rndseed = i;
+        game_setContext(previous);
+        games[i].seed = i;
+        games[i].hold = 0;
+        games[i].over = false;
+    }
+    sysbatch_games = count;
+
+    if (!syspool_init(sysarg_args_threads))
+    {
+        freeGames(count);
+        game_unloadData();
+        return;
+    }
+
+    start = now();
+    for (frame = 0; frame < sysarg_args_frames; frame++)
+    {
+        syspool_run(stepGame, NULL, count);
+    }
+    seconds = now() - start;
+
+    sys_printf("xrick/batch: %u games x %u frames on %u threads in %.3f s",
+               count, sysarg_args_frames, syspool_threads, seconds);
+    if (seconds > 0)
+    {
+        sys_printf(", %.1f frames per second", (double)count * sysarg_args_frames / seconds);
+    }
+    sys_printf(", checksum %08x\n", checksum());
+
+    syspool_shutdown();
+    freeGames(count);
+    game_unloadData();
+}
+
+#endif /* ENABLE_BATCH */
+
+/* eof */
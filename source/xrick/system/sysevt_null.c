@@ -0,0 +1,41 @@
+/*
+ * xrick/system/sysevt_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+
+/*
+ * Process events, if any, then return
+ *
+ * There is no input device, hence no event. Runs limited by --frames are
+ * ended by game_run, once that many frames are presented.
+ */
+void
+sysevt_poll(void)
+{
+}
+
+/*
+ * Wait for an event, then process it and return
+ *
+ * Nothing would ever come, so do not block.
+ */
+void
+sysevt_wait(void)
+{
+    sysevt_poll();
+}
+
+/* eof */
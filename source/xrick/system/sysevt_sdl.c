@@ -100,6 +100,11 @@ processEvent()
     else if (key == SDLK_F9) {
       game_toggleCheat(Cheat_EXPOSE);
     }
+#endif
+#ifdef ENABLE_PROFILER
+    else if (key == SDLK_F10) {
+      sysprof_dump();
+    }
 #endif
     break;
   case SDL_KEYUP:
@@ -192,10 +197,13 @@ processEvent()
 
 /*
  * Process events, if any, then return
+ *
+ * Events are not pumped while a frame is being presented, see sysvid_sdl.c.
  */
 void
 sysevt_poll(void)
 {
+  sysvid_wait();
   while (SDL_PollEvent(&event))
     processEvent();
 }
@@ -206,6 +214,7 @@ sysevt_poll(void)
 void
 sysevt_wait(void)
 {
+  sysvid_wait();
   SDL_WaitEvent(&event);
   processEvent();
 }
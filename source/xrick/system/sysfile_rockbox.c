@@ -46,7 +46,7 @@ static char *rootPath = NULL;
  */
 bool sysfile_setRootPath(const char *name)
 {
-    rootPath = u_strdup(name);
+    rootPath = u_strdup(name, SYSMEM_TAG_PATHS);
     return (rootPath != NULL);
 }
 
@@ -67,7 +67,7 @@ file_t sysfile_open(const char *name)
     int fd;
 
     size_t fullPathLength = rb->strlen(rootPath) + rb->strlen(name) + 2;
-    char *fullPath = sysmem_push(fullPathLength);
+    char *fullPath = sysmem_push(fullPathLength, SYSMEM_TAG_PATHS);
     if (!fullPath)
     {
         return NULL;
@@ -74,7 +74,7 @@ static char *str_toNativeSeparators(char *);
 bool
 sysfile_setRootPath(const char *name)
 {
-    char *path = u_strdup(name);
+    char *path = u_strdup(name, SYSMEM_TAG_PATHS);
     if (!path)
     {
         return false;
@@ -138,7 +138,7 @@ sysfile_open(const char *name)
 #endif /* ENABLE_ZIP */
     {
         FILE *fh;
-        char *fullPath = sysmem_push(strlen(rootPath.name) + strlen(name) + 2);
+        char *fullPath = sysmem_push(strlen(rootPath.name) + strlen(name) + 2, SYSMEM_TAG_PATHS);
         if (!fullPath)
         {
             return NULL;
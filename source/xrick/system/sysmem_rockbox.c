@@ -35,18 +35,29 @@ enum
 {
     ALIGNMENT = sizeof(void*)  /* this is more of an educated guess; might want to adjust for your specific architecture */
 };
-static U8 * stackBuffer;
-static U8 * stackTop;
-static size_t stackSize;
-static size_t stackMaxSize;
+typedef struct {
+    U32 size;  /* whole block, header and padding included */
+    U32 tag;
+} header_t;  /* stored right before a block */
+static sysmem_stack_t mainStack;
+static THREAD_LOCAL sysmem_stack_t *stack = &mainStack;
+static sysmem_usage_t retiredUsage[SYSMEM_NBR_TAGS];  /* peaks of retired stacks */
+static size_t retiredMaxSize = 0;
 static bool isMemoryInitialised = false;
-IFDEBUG_MEMORY( static size_t maxUsedMemory = 0; );
+static const char *const tagNames[SYSMEM_NBR_TAGS] = {
+    "resources", "sounds", "video", "paths", "game", "rects", "total"
+};
+
+static void printUsage(const char *, const sysmem_usage_t *, size_t);
 
 /*
  * Initialise memory stack
  */
 bool sysmem_init(void)
 {
+    void *buffer;
+    size_t bufferSize;
+
     if (isMemoryInitialised)
     {
         return true;
@@ -58,9 +69,8 @@ bool sysmem_init(void)
         rb->audio_stop();
     }
 
-    stackBuffer = rb->plugin_get_audio_buffer(&stackMaxSize);
-    stackTop = stackBuffer;
-    stackSize = 0;
+    buffer = rb->plugin_get_audio_buffer(&bufferSize);
+    sysmem_initStack(&mainStack, buffer, bufferSize);
     isMemoryInitialised = true;
     return true;
 }
@@ -75,44 +85,119 @@ void sysmem_shutdown(void)
         return;
     }
 
-    if (stackTop != stackBuffer || stackSize != 0)
+    if (mainStack.top != mainStack.buffer || mainStack.size != 0)
     {
         sys_error("(memory) improper deallocation detected");
     }
 
-    IFDEBUG_MEMORY(
-        sys_printf("xrick/memory: max memory usage was %u bytes\n", maxUsedMemory);
-    );
+    printUsage("main stack", mainStack.usage, mainStack.maxSize);
+    printUsage("retired stacks", retiredUsage, retiredMaxSize);
 
     isMemoryInitialised = false;
 }
 
+/*
+ * Initialise a memory stack over a buffer
+ */
+void sysmem_initStack(sysmem_stack_t *newStack, void *buffer, size_t size)
+{
+    sysmem_tag_t tag;
+
+    newStack->buffer = buffer;
+    newStack->top = buffer;
+    newStack->size = 0;
+    newStack->maxSize = size;
+    for (tag = 0; tag < SYSMEM_NBR_TAGS; tag++)
+    {
+        newStack->usage[tag].current = 0;
+        newStack->usage[tag].peak = 0;
+    }
+}
+
+/*
+ * Retire a memory stack
+ *
+ * Its peak usage is kept for the summary printed by sysmem_shutdown.
+ * Stacks must be retired by the thread that owns the main stack.
+ */
+void sysmem_freeStack(const sysmem_stack_t *oldStack)
+{
+    sysmem_tag_t tag;
+
+    if (oldStack->top != oldStack->buffer || oldStack->size != 0)
+    {
+        sys_error("(memory) improper deallocation detected");
+    }
+
+    for (tag = 0; tag < SYSMEM_NBR_TAGS; tag++)
+    {
+        if (oldStack->usage[tag].peak > retiredUsage[tag].peak)
+        {
+            retiredUsage[tag].peak = oldStack->usage[tag].peak;
+        }
+    }
+    if (oldStack->maxSize > retiredMaxSize)
+    {
+        retiredMaxSize = oldStack->maxSize;
+    }
+}
+
+/*
+ * Select the memory stack of the calling thread
+ *
+ * newStack: stack to use from now on, NULL for the main stack.
+ * return: previous stack.
+ */
+sysmem_stack_t *sysmem_setStack(sysmem_stack_t *newStack)
+{
+    sysmem_stack_t *previous = stack;
+
+    stack = newStack ? newStack : &mainStack;
+    return previous;
+}
+
+/*
+ * Count bytes in, or out (negative size), of a usage
+ */
+static void account(sysmem_usage_t *usage, ptrdiff_t size)
+{
+    usage->current += size;
+    if (usage->current > usage->peak)
+    {
+        usage->peak = usage->current;
+    }
+}
+
 /*
  * Allocate a memory-aligned block on top of the memory stack
+ *
+ * tag: what the block is for.
  */
-void *sysmem_push(size_t size)
+void *sysmem_push(size_t size, sysmem_tag_t tag)
 {
     uintptr_t alignedPtr;
-    size_t * allocatedSizePtr;
+    header_t * header;
 
-    size_t neededSize = sizeof(size_t) + size + (ALIGNMENT - 1);
-    if (stackSize + neededSize > stackMaxSize)
+    size_t neededSize = sizeof(header_t) + size + (ALIGNMENT - 1);
+    if (stack->size + neededSize > stack->maxSize)
     {
-        sys_error("(memory) tried to allocate a block when memory full");
+        sys_error("(memory) tried to allocate a %s block when memory full", tagNames[tag]);
         return NULL;
     }
 
-    alignedPtr = (((uintptr_t)stackTop) + sizeof(size_t) + ALIGNMENT) & ~((uintptr_t)(ALIGNMENT - 1));
+    alignedPtr = (((uintptr_t)stack->top) + sizeof(header_t) + ALIGNMENT) & ~((uintptr_t)(ALIGNMENT - 1));
 
-    allocatedSizePtr = (size_t *)(alignedPtr);
-    allocatedSizePtr[-1] = neededSize;
+    header = (header_t *)(alignedPtr);
+    header[-1].size = (U32)neededSize;
+    header[-1].tag = (U32)tag;
 
-    stackTop += neededSize;
-    stackSize += neededSize;
+    stack->top += neededSize;
+    stack->size += neededSize;
+    account(&stack->usage[tag], neededSize);
+    account(&stack->usage[SYSMEM_TAG_TOTAL], neededSize);
 
     IFDEBUG_MEMORY(
-        sys_printf("xrick/memory: allocated %u bytes\n", neededSize);
-        if (stackSize > maxUsedMemory) maxUsedMemory = stackSize;
+        sys_printf("xrick/memory: allocated %u bytes (%s)\n", neededSize, tagNames[tag]);
     );
 
     return (void *)alignedPtr;
@@ -124,24 +209,28 @@ void *sysmem_push(size_t size)
 void sysmem_pop(void * alignedPtr)
 {
     size_t allocatedSize;
+    sysmem_tag_t tag;
 
     if (!alignedPtr)
     {
         return;
     }
 
-    if (stackSize == 0)
+    if (stack->size == 0)
     {
         sys_error("(memory) tried to release a block when memory empty");
         return;
     }
 
-    allocatedSize = ((size_t *)(alignedPtr))[-1];
-    stackTop -= allocatedSize;
-    stackSize -= allocatedSize;
+    allocatedSize = ((header_t *)(alignedPtr))[-1].size;
+    tag = (sysmem_tag_t)((header_t *)(alignedPtr))[-1].tag;
+    stack->top -= allocatedSize;
+    stack->size -= allocatedSize;
+    account(&stack->usage[tag], -(ptrdiff_t)allocatedSize);
+    account(&stack->usage[SYSMEM_TAG_TOTAL], -(ptrdiff_t)allocatedSize);
 
     IFDEBUG_MEMORY(
-        if ((uintptr_t)alignedPtr != ((((uintptr_t)stackTop) + sizeof(size_t) + ALIGNMENT) & ~((uintptr_t)(ALIGNMENT - 1))))
+        if ((uintptr_t)alignedPtr != ((((uintptr_t)stack->top) + sizeof(header_t) + ALIGNMENT) & ~((uintptr_t)(ALIGNMENT - 1))))
         {
             sys_error("(memory) tried to release a wrong block");
             return;
@@ -149,8 +238,93 @@ void sysmem_pop(void * alignedPtr)
     );
 
     IFDEBUG_MEMORY(
-        sys_printf("xrick/memory: released %u bytes\n", allocatedSize);
+        sys_printf("xrick/memory: released %u bytes (%s)\n", allocatedSize, tagNames[tag]);
+    );
+}
+
+/*
+ * Set a mark at the top of the memory stack
+ *
+ * mark: CHANGED
+ * name: mark name, for debugging
+ */
+void sysmem_mark(sysmem_mark_t *mark, const char *name)
+{
+    sysmem_tag_t tag;
+
+    mark->stack = stack;
+    mark->size = stack->size;
+    for (tag = 0; tag < SYSMEM_NBR_TAGS; tag++)
+    {
+        mark->usage[tag] = stack->usage[tag].current;
+    }
+    mark->name = name;
+}
+
+/*
+ * Release every block pushed on the memory stack since a mark was set
+ */
+void sysmem_release(const sysmem_mark_t *mark)
+{
+    sysmem_tag_t tag;
+
+    if (mark->stack != stack)
+    {
+        sys_error("(memory) tried to release mark '%s' of another stack", mark->name);
+        return;
+    }
+
+    if (mark->size > stack->size)
+    {
+        sys_error("(memory) tried to release mark '%s' above the top", mark->name);
+        return;
+    }
+
+    IFDEBUG_MEMORY(
+        if (stack->size != mark->size)
+        {
+            sys_printf("xrick/memory: released %u bytes to mark '%s'\n",
+                       stack->size - mark->size, mark->name);
+        }
     );
+
+    stack->top = stack->buffer + mark->size;
+    stack->size = mark->size;
+    for (tag = 0; tag < SYSMEM_NBR_TAGS; tag++)
+    {
+        stack->usage[tag].current = mark->usage[tag];
+    }
+}
+
+/*
+ * Get the current and peak usage of a tag on the memory stack
+ */
+const sysmem_usage_t *sysmem_getUsage(sysmem_tag_t tag)
+{
+    return &stack->usage[tag];
+}
+
+/*
+ * Print the peak usage of stacks, one tag after the other
+ */
+static void printUsage(const char *name, const sysmem_usage_t *usage, size_t maxSize)
+{
+    sysmem_tag_t tag;
+
+    if (!usage[SYSMEM_TAG_TOTAL].peak)
+    {
+        return;
+    }
+
+    sys_printf("xrick/memory: %s peak %u of %u bytes", name, usage[SYSMEM_TAG_TOTAL].peak, maxSize);
+    for (tag = 0; tag < SYSMEM_TAG_TOTAL; tag++)
+    {
+        if (usage[tag].peak)
+        {
+            sys_printf(", %s %u", tagNames[tag], usage[tag].peak);
+        }
+    }
+    sys_printf("\n");
 }
 
 /* eof */
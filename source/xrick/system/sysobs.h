@@ -0,0 +1,84 @@
+/*
+ * xrick/system/sysobs.h
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Layout of the shared memory observation ring, for xrick and for the
+ * processes reading it. All values are in native byte order.
+ *
+ * The shared memory object starts with a header, followed by slotCount
+ * slots of slotSize bytes each. Frame n (counting from 1) goes to slot
+ * (n - 1) % slotCount. A slot starts with sysobs_slot_t, followed by the
+ * frame buffer (width * height bytes, palette indexes) at fbOffset and by
+ * the entity table (entCount entries of entSize bytes, see ent_t in ents.h)
+ * at entsOffset, both offsets being relative to the slot.
+ *
+ * The header is valid once magic reads SYSOBS_MAGIC: it is written last,
+ * with a release store, so readers must load it with an acquire load (e.g.
+ * __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE)) before reading any
+ * other header field. The same goes for published and seq.
+ *
+ * Reading frame n, with n <= published:
+ * - read seq of the slot: if it is not n, the slot has been overwritten
+ *   or is being written;
+ * - read what is needed, straight from the slot;
+ * - read seq again: if it is still n, what was read is consistent.
+ */
+
+#ifndef _SYSOBS_H
+#define _SYSOBS_H
+
+#include "xrick/system/basic_types.h"
+
+enum
+{
+    SYSOBS_VERSION = 1,
+    SYSOBS_SLOTS = 16  /* must be a power of 2 */
+};
+
+#define SYSOBS_MAGIC 0x4f4b5258  /* "XRKO" in memory, on little-endian hosts */
+
+typedef struct {
+    U32 magic;       /* SYSOBS_MAGIC, once the header is valid */
+    U32 version;     /* SYSOBS_VERSION */
+    U32 slotCount;
+    U32 slotSize;
+    U32 fbOffset;
+    U32 entsOffset;
+    U32 width;       /* frame buffer width */
+    U32 height;      /* frame buffer height */
+    U32 entSize;
+    U32 entCount;
+    U32 published;   /* number of frames published so far */
+    U8 padding[20];  /* pad to 64 bytes */
+} sysobs_header_t;
+
+typedef struct {
+    U32 seq;         /* frame number, 0 while being written */
+    U32 time;        /* game time, in milliseconds */
+    U32 score;
+    U32 state;       /* see game_state_t in context.h */
+    U16 map;
+    U16 submap;
+    U8 lives;
+    U8 bombs;
+    U8 bullets;
+    U8 padding[41];  /* pad to 64 bytes */
+} sysobs_slot_t;
+
+#endif /* ndef _SYSOBS_H */
+
+/* eof */
@@ -0,0 +1,180 @@
+/*
+ * xrick/system/sysobs_sdl.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Observation export (POSIX shared memory).
+ *
+ * Each presented frame is published to a ring of slots in a shared memory
+ * object (layout in sysobs.h), together with the entity table and the game
+ * counters, so that other processes can observe the game without any
+ * serialisation: they map the object and read frames where they are.
+ *
+ * There is one writer. A slot is claimed by zeroing its sequence number,
+ * then filled, then published by setting its sequence number to the frame
+ * number, and finally the header published count is updated. Readers
+ * check sequence numbers to detect slots overwritten while being read.
+ */
+
+#define _POSIX_C_SOURCE 200112L  /* shm_open, ftruncate */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+
+#ifdef ENABLE_OBSERVE
+
+#include "xrick/system/sysobs.h"
+#include "xrick/game.h"
+#include "xrick/ents.h"
+
+#include <fcntl.h>     /* O_CREAT */
+#include <string.h>    /* memcpy */
+#include <sys/mman.h>  /* shm_open, mmap */
+#include <unistd.h>    /* ftruncate, close */
+
+enum
+{
+    FB_OFFSET = sizeof(sysobs_slot_t),
+    FB_SIZE = SYSVID_WIDTH * SYSVID_HEIGHT,
+    ENTS_OFFSET = FB_OFFSET + FB_SIZE,
+    ENTS_SIZE = (ENT_ENTSNUM + 1) * sizeof(ent_t),
+    SLOT_SIZE = (ENTS_OFFSET + ENTS_SIZE + 63) & ~63,  /* keep slots on distinct cache lines */
+    SHM_SIZE = sizeof(sysobs_header_t) + SYSOBS_SLOTS * SLOT_SIZE
+};
+
+/*
+ * Local variables
+ */
+static U8 *shm = NULL;
+static sysobs_header_t *header;
+static U32 frameCount;
+
+/*
+ * Initialise observation export, if requested on the command line
+ */
+bool
+sysobs_init(void)
+{
+    int fd;
+
+    if (!sysarg_args_observe)
+    {
+        return true;
+    }
+
+    fd = shm_open(sysarg_args_observe, O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        sys_error("(observe) can not open shared memory \"%s\"", sysarg_args_observe);
+        return false;
+    }
+    if (ftruncate(fd, SHM_SIZE) != 0)
+    {
+        sys_error("(observe) can not size shared memory");
+        close(fd);
+        shm_unlink(sysarg_args_observe);
+        return false;
+    }
+    shm = mmap(NULL, SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED)
+    {
+        sys_error("(observe) can not map shared memory");
+        shm = NULL;
+        shm_unlink(sysarg_args_observe);
+        return false;
+    }
+
+    memset(shm, 0, SHM_SIZE);
+    header = (sysobs_header_t *)shm;
+    header->version = SYSOBS_VERSION;
+    header->slotCount = SYSOBS_SLOTS;
+    header->slotSize = SLOT_SIZE;
+    header->fbOffset = FB_OFFSET;
+    header->entsOffset = ENTS_OFFSET;
+    header->width = SYSVID_WIDTH;
+    header->height = SYSVID_HEIGHT;
+    header->entSize = sizeof(ent_t);
+    header->entCount = ENT_ENTSNUM + 1;
+    header->published = 0;
+    /* publish the header: readers load the magic first, then the rest */
+    __atomic_store_n(&header->magic, SYSOBS_MAGIC, __ATOMIC_RELEASE);
+
+    frameCount = 0;
+    return true;
+}
+
+/*
+ * Terminate observation export
+ *
+ * The shared memory object is removed; readers still mapping it can
+ * go on reading the last frames.
+ */
+void
+sysobs_shutdown(void)
+{
+    if (!shm)
+    {
+        return;
+    }
+
+    munmap(shm, SHM_SIZE);
+    shm = NULL;
+    shm_unlink(sysarg_args_observe);
+}
+
+/*
+ * Publish current frame of the current context
+ */
+void
+sysobs_update(void)
+{
+    sysobs_slot_t *slot;
+    U8 *data;
+
+    if (!shm)
+    {
+        return;
+    }
+
+    frameCount++;
+    data = shm + sizeof(sysobs_header_t) + ((frameCount - 1) & (SYSOBS_SLOTS - 1)) * SLOT_SIZE;
+    slot = (sysobs_slot_t *)data;
+
+    /* claim */
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    /* fill */
+    slot->time = game_time;
+    slot->score = game_score;
+    slot->state = game_ctx->game_state;
+    slot->map = game_map;
+    slot->submap = game_submap;
+    slot->lives = game_lives;
+    slot->bombs = game_bombs;
+    slot->bullets = game_bullets;
+    memcpy(data + FB_OFFSET, game_ctx->framebuffer, FB_SIZE);
+    memcpy(data + ENTS_OFFSET, ent_ents, ENTS_SIZE);
+
+    /* publish */
+    __atomic_store_n(&slot->seq, frameCount, __ATOMIC_RELEASE);
+    __atomic_store_n(&header->published, frameCount, __ATOMIC_RELEASE);
+}
+
+#endif /* ENABLE_OBSERVE */
+
+/* eof */
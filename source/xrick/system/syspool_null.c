@@ -0,0 +1,314 @@
+/*
+ * xrick/system/syspool_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Work-stealing thread pool (POSIX threads).
+ *
+ * syspool_run executes tasks 0 to count-1 and returns once all of them are
+ * done. The calling thread works too. Tasks are first split evenly: each
+ * thread owns a range of task numbers and takes tasks from the front of it.
+ * A thread whose range is empty steals the back half of the range of
+ * another thread, hence slow tasks do not hold everybody else back.
+ *
+ * A range is packed in a single 64 bits word (begin in the low half, end
+ * in the high half) so that taking and stealing are one compare-and-swap.
+ */
+
+#define _POSIX_C_SOURCE 200112L  /* sysconf */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+
+#ifdef ENABLE_BATCH
+
+#include <pthread.h>
+#include <stdlib.h>  /* malloc */
+#include <unistd.h>  /* sysconf */
+
+enum
+{
+    MAX_THREADS = 256,
+    CACHE_LINE_SIZE = 64
+};
+
+typedef struct {
+    uint64_t range;  /* tasks not taken yet: begin (low), end (high) */
+    U32 index;
+    pthread_t thread;
+    U8 padding[CACHE_LINE_SIZE];  /* keep ranges on distinct cache lines */
+} worker_t;
+
+/*
+ * Global variables
+ */
+U32 syspool_threads = 0;
+
+/*
+ * Local variables
+ */
+static worker_t *workers = NULL;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t startCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t doneCond = PTHREAD_COND_INITIALIZER;
+static U32 generation = 0;  /* incremented for each syspool_run */
+static U32 running = 0;  /* threads still working on current generation */
+static bool quitting = false;
+static syspool_task_t currentTask;
+static void *currentData;
+
+/*
+ * Pack / unpack a range
+ */
+static uint64_t
+pack(U32 begin, U32 end)
+{
+    return (uint64_t)begin | ((uint64_t)end << 32);
+}
+
+static U32
+rangeBegin(uint64_t range)
+{
+    return (U32)range;
+}
+
+static U32
+rangeEnd(uint64_t range)
+{
+    return (U32)(range >> 32);
+}
+
+/*
+ * Take the task at the front of a worker own range
+ *
+ * return: true if a task was taken
+ */
+static bool
+takeTask(worker_t *self, U32 *task)
+{
+    uint64_t range = __atomic_load_n(&self->range, __ATOMIC_ACQUIRE);
+
+    while (rangeBegin(range) < rangeEnd(range))
+    {
+        if (__atomic_compare_exchange_n(&self->range, &range,
+                                        pack(rangeBegin(range) + 1, rangeEnd(range)),
+                                        true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            *task = rangeBegin(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Steal the back half of the range of another worker
+ *
+ * return: true if some tasks were stolen
+ *
+ * Only called while self range is empty: nobody else can modify it, hence
+ * the stolen tasks can be stored in it without compare-and-swap.
+ */
+static bool
+stealTasks(worker_t *self)
+{
+    U32 i;
+
+    for (i = 1; i < syspool_threads; i++)
+    {
+        worker_t *victim = &workers[(self->index + i) % syspool_threads];
+        uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+        while (rangeBegin(range) < rangeEnd(range))
+        {
+            U32 middle = rangeBegin(range) + (rangeEnd(range) - rangeBegin(range)) / 2;
+
+            if (__atomic_compare_exchange_n(&victim->range, &range,
+                                            pack(rangeBegin(range), middle),
+                                            true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                __atomic_store_n(&self->range, pack(middle, rangeEnd(range)), __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*
+ * Run tasks until there are none left anywhere
+ */
+static void
+work(worker_t *self)
+{
+    U32 task;
+
+    do
+    {
+        while (takeTask(self, &task))
+        {
+            currentTask(currentData, task);
+        }
+    } while (stealTasks(self));
+}
+
+/*
+ * Worker thread
+ */
+static void *
+workerMain(void *arg)
+{
+    worker_t *self = arg;
+    U32 seen = 0;
+
+    pthread_mutex_lock(&mutex);
+    for (;;)
+    {
+        while (generation == seen && !quitting)
+        {
+            pthread_cond_wait(&startCond, &mutex);
+        }
+        if (quitting)
+        {
+            break;
+        }
+        seen = generation;
+        pthread_mutex_unlock(&mutex);
+
+        work(self);
+
+        pthread_mutex_lock(&mutex);
+        if (--running == 0)
+        {
+            pthread_cond_signal(&doneCond);
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return NULL;
+}
+
+/*
+ * Initialise thread pool
+ *
+ * threads: number of threads, including the calling one, 0 for one
+ *          per processor.
+ */
+bool
+syspool_init(U32 threads)
+{
+    U32 i;
+
+    if (threads == 0)
+    {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (U32)processors : 1;
+    }
+    if (threads > MAX_THREADS)
+    {
+        threads = MAX_THREADS;
+    }
+
+    workers = malloc(threads * sizeof(*workers));
+    if (!workers)
+    {
+        sys_error("(pool) workers malloc failed");
+        return false;
+    }
+
+    quitting = false;
+    generation = 0;
+    syspool_threads = 1;
+    workers[0].index = 0;
+    workers[0].range = 0;
+    /* thread 0 is the calling thread */
+    for (i = 1; i < threads; i++)
+    {
+        workers[i].index = i;
+        workers[i].range = 0;
+        if (pthread_create(&workers[i].thread, NULL, workerMain, &workers[i]) != 0)
+        {
+            sys_error("(pool) can not create thread");
+            syspool_shutdown();
+            return false;
+        }
+        syspool_threads++;
+    }
+    return true;
+}
+
+/*
+ * Shutdown thread pool
+ */
+void
+syspool_shutdown(void)
+{
+    U32 i;
+
+    if (!workers)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&mutex);
+    quitting = true;
+    pthread_cond_broadcast(&startCond);
+    pthread_mutex_unlock(&mutex);
+
+    for (i = 1; i < syspool_threads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    free(workers);
+    workers = NULL;
+    syspool_threads = 0;
+}
+
+/*
+ * Run tasks 0 to count-1, return once they are all done
+ */
+void
+syspool_run(syspool_task_t task, void *data, U32 count)
+{
+    U32 i;
+
+    currentTask = task;
+    currentData = data;
+    for (i = 0; i < syspool_threads; i++)
+    {
+        workers[i].range = pack((U32)((uint64_t)count * i / syspool_threads),
+                                (U32)((uint64_t)count * (i + 1) / syspool_threads));
+    }
+
+    pthread_mutex_lock(&mutex);
+    running = syspool_threads - 1;
+    generation++;
+    pthread_cond_broadcast(&startCond);
+    pthread_mutex_unlock(&mutex);
+
+    work(&workers[0]);
+
+    pthread_mutex_lock(&mutex);
+    while (running > 0)
+    {
+        pthread_cond_wait(&doneCond, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+#endif /* ENABLE_BATCH */
+
+/* eof */
@@ -0,0 +1,217 @@
+/*
+ * xrick/system/sysprof_sdl.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Frame profiler.
+ *
+ * Each timed phase adds one sample (phase, duration in nanoseconds) to a
+ * ring buffer. Adding a sample takes no lock: the slot is reserved by
+ * atomically incrementing the ring head, then published through its
+ * sequence number, so that games running on several threads can share
+ * the ring. The oldest samples get overwritten, hence statistics are
+ * about the last RING_SIZE samples.
+ *
+ * A reader checks the sequence number of a slot before and after reading
+ * it, and skips the slot when it is being, or has been, overwritten.
+ */
+
+#define _POSIX_C_SOURCE 200112L  /* clock_gettime */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+
+#include <stdlib.h> /* malloc, qsort */
+
+#ifdef __WIN32__
+#include <windows.h>  /* QueryPerformanceCounter */
+#else
+#include <time.h>     /* clock_gettime */
+#endif
+
+/*
+ * Return a high resolution timestamp, in nanoseconds
+ *
+ * Wraps around every 4.29 seconds: only differences are meaningful.
+ */
+U32
+sysprof_time(void)
+{
+#ifdef __WIN32__
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (!frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (U32)((counter.QuadPart / frequency.QuadPart) * 1000000000 +
+                 (counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (U32)ts.tv_sec * 1000000000u + (U32)ts.tv_nsec;
+#endif
+}
+
+#ifdef ENABLE_PROFILER
+
+enum
+{
+    RING_SIZE = 1 << 15  /* must be a power of 2 */
+};
+
+typedef struct {
+    U32 seq;       /* index of the sample + 1, 0 while being written */
+    U32 duration;  /* nanoseconds */
+    U32 phase;
+} sample_t;
+
+/*
+ * Atomic operations
+ */
+#ifdef _MSC_VER
+#define atomicFetchAdd(p, v) ((U32)InterlockedExchangeAdd((volatile LONG *)(p), (v)))
+#define atomicLoad(p) (*(volatile U32 *)(p))  /* acquire semantics with MSVC */
+#define atomicStore(p, v) (*(volatile U32 *)(p) = (v))  /* release semantics with MSVC */
+#define atomicFence() MemoryBarrier()
+#else
+#define atomicFetchAdd(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#define atomicLoad(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define atomicStore(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define atomicFence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+static const char *phaseNames[SYSPROF_NBR_PHASES] = {
+    "ent_action", "ent_draw", "draw_map", "draw_drawStatus",
+    "scroll_up", "scroll_down", "sysvid_update", "sysevt_poll"
+};
+
+/*
+ * Local variables
+ */
+static sample_t ring[RING_SIZE];
+static U32 head = 0;  /* index of next sample */
+
+/*
+ * Add a sample
+ */
+void
+sysprof_add(sysprof_phase_t phase, U32 duration)
+{
+    U32 index = atomicFetchAdd(&head, 1);
+    sample_t *sample = &ring[index & (RING_SIZE - 1)];
+
+    atomicStore(&sample->seq, 0);
+    atomicFence();
+    sample->duration = duration;
+    sample->phase = phase;
+    atomicStore(&sample->seq, index + 1);
+}
+
+/*
+ * Compare durations, for qsort
+ */
+static int
+compareDurations(const void *a, const void *b)
+{
+    U32 da = *(const U32 *)a;
+    U32 db = *(const U32 *)b;
+
+    return (da > db) - (da < db);
+}
+
+/*
+ * Print min, average and 99th percentile duration of each phase
+ */
+void
+sysprof_dump(void)
+{
+    U32 *durations[SYSPROF_NBR_PHASES];
+    U32 counts[SYSPROF_NBR_PHASES];
+    U32 last = atomicLoad(&head);
+    U32 first = last > RING_SIZE ? last - RING_SIZE : 0;
+    U32 i;
+
+    if (last == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < SYSPROF_NBR_PHASES; i++)
+    {
+        durations[i] = malloc(RING_SIZE * sizeof(U32));
+        counts[i] = 0;
+        if (!durations[i])
+        {
+            sys_error("(profiler) malloc failed");
+            while (i--)
+            {
+                free(durations[i]);
+            }
+            return;
+        }
+    }
+
+    /* gather samples */
+    for (i = first; i != last; i++)
+    {
+        sample_t *sample = &ring[i & (RING_SIZE - 1)];
+        U32 seq = atomicLoad(&sample->seq);
+        U32 duration = sample->duration;
+        U32 phase = sample->phase;
+
+        atomicFence();
+        if (seq != i + 1 || atomicLoad(&sample->seq) != seq || phase >= SYSPROF_NBR_PHASES)
+        {
+            continue;  /* being overwritten */
+        }
+        durations[phase][counts[phase]++] = duration;
+    }
+
+    sys_printf("xrick/profiler: %-16s %8s %10s %10s %10s (microseconds)\n",
+               "phase", "samples", "min", "avg", "p99");
+    for (i = 0; i < SYSPROF_NBR_PHASES; i++)
+    {
+        U32 n = counts[i];
+        double sum = 0;
+        U32 k;
+
+        if (n == 0)
+        {
+            free(durations[i]);
+            continue;
+        }
+
+        qsort(durations[i], n, sizeof(U32), compareDurations);
+        for (k = 0; k < n; k++)
+        {
+            sum += durations[i][k];
+        }
+        sys_printf("xrick/profiler: %-16s %8u %10.2f %10.2f %10.2f\n",
+                   phaseNames[i], n,
+                   durations[i][0] / 1000.0,
+                   sum / n / 1000.0,
+                   durations[i][(n - 1) * 99 / 100] / 1000.0);
+        free(durations[i]);
+    }
+}
+
+#endif /* ENABLE_PROFILER */
+
+/* eof */
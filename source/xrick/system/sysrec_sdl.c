@@ -0,0 +1,333 @@
+/*
+ * xrick/system/sysrec_sdl.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Input recording and replay.
+ *
+ * The game only ever sees control_status, and only between two frames,
+ * hence recording control_status once per frame (after events have been
+ * processed) is enough to reproduce a run, provided that the run starts
+ * from the same map, submap and random seed.
+ *
+ * File layout (all values little endian):
+ *
+ *   header   "XRKR", version (U8), graphics (U8: 0 ST, 1 PC),
+ *            map (U16), submap (U16), random seed (U32),
+ *            frames count (U32), frame buffer checksum (U32)
+ *   frames   pairs of (control status (U8), repeat count (U8))
+ *
+ * The frames count and the checksum of the frame buffer after the last
+ * frame are written once the recording is over. When replaying, they are
+ * used to check that the replay did not diverge.
+ */
+
+#include "xrick/config.h"
+
+#ifdef ENABLE_REPLAY
+
+#include "xrick/system/system.h"
+#include "xrick/control.h"
+#include "xrick/game.h"
+
+#include <stdio.h>  /* fopen fread fwrite */
+#include <string.h> /* memcmp */
+
+enum
+{
+    HEADER_SIZE = 22,
+    HEADER_FRAMES_OFFSET = 14,
+    VERSION = 1
+};
+
+static const U8 magic[4] = { 'X', 'R', 'K', 'R' };
+
+#ifdef GFXST
+static const U8 graphics = 0;
+#endif
+#ifdef GFXPC
+static const U8 graphics = 1;
+#endif
+
+/*
+ * Global variables
+ */
+bool sysrec_replaying = false;
+U32 sysrec_seed = 0;
+
+/*
+ * Local variables
+ */
+static FILE *recordFile = NULL;
+static FILE *replayFile = NULL;
+static U32 frameCount = 0;
+static U32 expectedFrameCount = 0;
+static U32 expectedChecksum = 0;
+static U8 runStatus = 0;
+static U8 runLength = 0;
+
+/*
+ * Write little endian values
+ */
+static void
+putU16(U8 *p, U16 v)
+{
+    p[0] = (U8)v;
+    p[1] = (U8)(v >> 8);
+}
+
+static void
+putU32(U8 *p, U32 v)
+{
+    putU16(p, (U16)v);
+    putU16(p + 2, (U16)(v >> 16));
+}
+
+/*
+ * Read little endian values
+ */
+static U16
+getU16(const U8 *p)
+{
+    return (U16)(p[0] | (p[1] << 8));
+}
+
+static U32
+getU32(const U8 *p)
+{
+    return getU16(p) | ((U32)getU16(p + 2) << 16);
+}
+
+/*
+ * Checksum (FNV-1a) of the frame buffer and score
+ */
+static U32
+checksum(void)
+{
+    U32 h = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < SYSVID_WIDTH * SYSVID_HEIGHT; i++)
+    {
+        h = (h ^ sysvid_fb[i]) * 16777619u;
+    }
+    h = (h ^ game_score) * 16777619u;
+    return h;
+}
+
+/*
+ * Flush pending run of identical control status
+ */
+static bool
+flushRun(void)
+{
+    U8 pair[2];
+
+    if (runLength == 0)
+    {
+        return true;
+    }
+    pair[0] = runStatus;
+    pair[1] = runLength;
+    runLength = 0;
+    return fwrite(pair, sizeof(pair), 1, recordFile) == 1;
+}
+
+/*
+ * Start recording
+ */
+static bool
+startRecording(const char *name)
+{
+    U8 header[HEADER_SIZE];
+
+    recordFile = fopen(name, "wb");
+    if (!recordFile)
+    {
+        sys_error("(replay) can not create file \"%s\"", name);
+        return false;
+    }
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, magic, sizeof(magic));
+    header[4] = VERSION;
+    header[5] = graphics;
+    putU16(header + 6, (U16)sysarg_args_map);
+    putU16(header + 8, (U16)sysarg_args_submap);
+    putU32(header + 10, sysrec_seed);
+    /* frames count and checksum are written at the end */
+
+    if (fwrite(header, sizeof(header), 1, recordFile) != 1)
+    {
+        sys_error("(replay) can not write to file \"%s\"", name);
+        fclose(recordFile);
+        recordFile = NULL;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Start replaying
+ */
+static bool
+startReplaying(const char *name)
+{
+    U8 header[HEADER_SIZE];
+
+    replayFile = fopen(name, "rb");
+    if (!replayFile)
+    {
+        sys_error("(replay) can not open file \"%s\"", name);
+        return false;
+    }
+
+    if (fread(header, sizeof(header), 1, replayFile) != 1 ||
+        memcmp(header, magic, sizeof(magic)) != 0 ||
+        header[4] != VERSION)
+    {
+        sys_error("(replay) \"%s\" is not a valid recording", name);
+        fclose(replayFile);
+        replayFile = NULL;
+        return false;
+    }
+    if (header[5] != graphics)
+    {
+        sys_error("(replay) \"%s\" was recorded with other graphics", name);
+        fclose(replayFile);
+        replayFile = NULL;
+        return false;
+    }
+
+    sysarg_args_map = getU16(header + 6);
+    sysarg_args_submap = getU16(header + 8);
+    sysrec_seed = getU32(header + 10);
+    expectedFrameCount = getU32(header + HEADER_FRAMES_OFFSET);
+    expectedChecksum = getU32(header + HEADER_FRAMES_OFFSET + 4);
+
+    sysrec_replaying = true;
+    return true;
+}
+
+/*
+ * Initialise recording or replay, as requested on the command line
+ */
+bool
+sysrec_init(void)
+{
+    frameCount = 0;
+    runLength = 0;
+
+    if (sysarg_args_replay)
+    {
+        return startReplaying(sysarg_args_replay);
+    }
+    if (sysarg_args_record)
+    {
+        return startRecording(sysarg_args_record);
+    }
+    return true;
+}
+
+/*
+ * Terminate recording or replay
+ */
+void
+sysrec_shutdown(void)
+{
+    if (recordFile)
+    {
+        U8 footer[8];
+
+        putU32(footer, frameCount);
+        putU32(footer + 4, checksum());
+        if (!flushRun() ||
+            fseek(recordFile, HEADER_FRAMES_OFFSET, SEEK_SET) != 0 ||
+            fwrite(footer, sizeof(footer), 1, recordFile) != 1)
+        {
+            sys_error("(replay) can not complete recording");
+        }
+        fclose(recordFile);
+        recordFile = NULL;
+    }
+
+    if (replayFile)
+    {
+        U32 sum = checksum();
+
+        if (frameCount != expectedFrameCount || sum != expectedChecksum)
+        {
+            sys_printf("xrick/replay: replay diverged: %u frames, checksum %08x"
+                       " (recorded: %u frames, checksum %08x)\n",
+                       frameCount, sum, expectedFrameCount, expectedChecksum);
+        }
+        else
+        {
+            sys_printf("xrick/replay: replay matched recording (%u frames)\n", frameCount);
+        }
+        fclose(replayFile);
+        replayFile = NULL;
+        sysrec_replaying = false;
+    }
+}
+
+/*
+ * Record, or replay, control status for the next frame
+ */
+void
+sysrec_update(void)
+{
+    if (recordFile)
+    {
+        frameCount++;
+        if (runLength > 0 && (control_status != runStatus || runLength == 0xff))
+        {
+            if (!flushRun())
+            {
+                sys_error("(replay) can not write recording");
+                fclose(recordFile);
+                recordFile = NULL;
+                return;
+            }
+        }
+        runStatus = (U8)control_status;
+        runLength++;
+    }
+    else if (replayFile)
+    {
+        if (runLength == 0)
+        {
+            U8 pair[2];
+
+            if (fread(pair, sizeof(pair), 1, replayFile) != 1 || pair[1] == 0)
+            {
+                /* end of recording */
+                control_set(Control_EXIT);
+                return;
+            }
+            runStatus = pair[0];
+            runLength = pair[1];
+        }
+        frameCount++;
+        runLength--;
+        /* keep exit requests from the user, drop everything else */
+        control_status = runStatus | (control_status & Control_EXIT);
+    }
+}
+
+#endif /* ENABLE_REPLAY */
+
+/* eof */
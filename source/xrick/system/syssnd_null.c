@@ -0,0 +1,98 @@
+/*
+ * xrick/system/syssnd_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+#include "xrick/config.h"
+
+#ifdef ENABLE_SOUND
+
+#include "xrick/system/system.h"
+
+/*
+ * Global variables
+ */
+const U8 syssnd_period = 0xff; /* nothing to mix */
+
+/*
+ * Initialise audio
+ */
+bool syssnd_init(void)
+{
+    return true;
+}
+
+/*
+ * Shutdown
+ */
+void syssnd_shutdown(void)
+{
+}
+
+/*
+ * Toggle mute
+ */
+void syssnd_toggleMute(void)
+{
+}
+
+/*
+ * Increase/decrease volume
+ */
+void syssnd_vol(S8 d/*unused*/)
+{
+    (void)d;
+}
+
+/*
+ * Play a sound
+ */
+void syssnd_play(sound_t *sound/*unused*/, S8 loop/*unused*/)
+{
+    (void)sound;
+    (void)loop;
+}
+
+/*
+ * Pause all sounds
+ */
+void syssnd_pauseAll(bool pause/*unused*/)
+{
+    (void)pause;
+}
+
+/*
+ * Stop a sound
+ */
+void syssnd_stop(sound_t *sound/*unused*/)
+{
+    (void)sound;
+}
+
+/*
+ * Stops all channels.
+ */
+void syssnd_stopAll(void)
+{
+}
+
+/*
+ * Mix audio samples and fill playback buffer
+ */
+void syssnd_update(void)
+{
+}
+
+#endif /* ENABLE_SOUND */
+
+/* eof */
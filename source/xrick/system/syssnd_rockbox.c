@@ -425,7 +425,7 @@ void syssnd_load(sound_t *sound)
     success = false;
     do
     {
-        sound->buf = sysmem_push(sound->len);
+        sound->buf = sysmem_push(sound->len, SYSMEM_TAG_SOUNDS);
         if (!sound->buf)
         {
             sys_error("(audio) not enough memory for \"%s\", %d bytes needed", sound->name, sound->len);
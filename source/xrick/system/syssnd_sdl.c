@@ -46,7 +46,6 @@ static bool sndMute = false;  /* mute flag */
 /*
  * prototypes
  */
-static void sdl_callback(void *userdata, U8 *stream, int len);
 static int sdlRWops_open(SDL_RWops *context, char *name);
 static int sdlRWops_seek(SDL_RWops *context, int offset, int whence);
 static int sdlRWops_read(SDL_RWops *context, void *ptr, int size, int maxnum);
@@ -61,7 +60,7 @@ static void endChannel(size_t);
  * may be more efficient to mix samples every frame, or maybe everytime a
  * new sound is sent to be played. I don't know.
  */
-static void sdl_callback(void *userdata/*unused*/, U8 *stream, int len)
+void syssnd_callback(void *userdata/*unused*/, U8 *stream, int len)
 {
     int i;
     (void)userdata;
@@ -153,7 +152,7 @@ bool syssnd_init(void)
     desired.format = AUDIO_U8;
     desired.channels = Wave_CHANNEL_COUNT;
     desired.samples = SYSSND_MIXSAMPLES;
-    desired.callback = sdl_callback;
+    desired.callback = syssnd_callback;
     desired.userdata = NULL;
 
     if (SDL_OpenAudio(&desired, &obtained) < 0)
@@ -430,7 +429,7 @@ void syssnd_free(sound_t *sound)
 /*
  * Mix audio samples and fill playback buffer
  *
- * Note: all work is currently done in "sdl_callback(...)". This might change in future.
+ * Note: all work is currently done in "syssnd_callback(...)". This might change in future.
  */
 void syssnd_update(void)
 {
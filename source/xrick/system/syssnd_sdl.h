@@ -40,6 +40,7 @@ typedef struct {
 
 extern void syssnd_load(sound_t *);
 extern void syssnd_free(sound_t *);
+extern void syssnd_callback(void *, U8 *, int);  /* mixer, called by the audio thread */
 
 #endif /* ENABLE_SOUND */
 
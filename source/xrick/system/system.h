@@ -66,17 +66,70 @@ extern void sys_printf(const char *, ...);
 extern void sys_snprintf(char *, size_t, const char *, ...);
 extern size_t sys_strlen(const char *);
 extern U32 sys_gettime(void);
-extern void sys_yield(void);
+extern void sys_sleep(U32);  /* milliseconds */
 extern bool sys_cacheData(void);
 extern void sys_uncacheData(void);
 
 /*
  * memory section
+ *
+ * Blocks are pushed on, and popped from, the current memory stack of the
+ * calling thread. The main stack is current by default; each game context
+ * brings its own stack so that games can run side by side.
+ *
+ * A mark remembers the top of the current stack: releasing it pops, at
+ * once, every block pushed since (e.g. whatever a frame allocated, see
+ * game_step). Marks are named for debugging.
+ *
+ * Every block is tagged with what it is for. Each stack counts the current
+ * and peak bytes of every tag, and sysmem_shutdown prints the peaks of the
+ * main stack and of the retired ones: this is how much memory a port
+ * needs to set aside.
  */
+#define SYSMEM_STACK_SIZE (1024*1024)  /* default main stack size, see --memory */
+#define SYSMEM_STACK_MIN_SIZE (640*1024)  /* the game data alone takes about 504KB */
+
+typedef enum {
+    SYSMEM_TAG_RESOURCES,  /* game data, see resources.c */
+    SYSMEM_TAG_SOUNDS,
+    SYSMEM_TAG_VIDEO,  /* frame buffers */
+    SYSMEM_TAG_PATHS,  /* file names */
+    SYSMEM_TAG_GAME,  /* game state of a context */
+    SYSMEM_TAG_RECTS,  /* rectangles of a frame */
+    SYSMEM_TAG_TOTAL,  /* whole stack, not to be pushed */
+    SYSMEM_NBR_TAGS
+} sysmem_tag_t;
+
+typedef struct {
+    size_t current;
+    size_t peak;
+} sysmem_usage_t;
+
+typedef struct {
+    U8 *buffer;
+    U8 *top;
+    size_t size;
+    size_t maxSize;
+    sysmem_usage_t usage[SYSMEM_NBR_TAGS];  /* bytes, block headers and padding included */
+} sysmem_stack_t;
+
+typedef struct {
+    sysmem_stack_t *stack;  /* stack the mark was set on */
+    size_t size;            /* size of that stack then */
+    size_t usage[SYSMEM_NBR_TAGS];  /* and current usage */
+    const char *name;
+} sysmem_mark_t;
+
 extern bool sysmem_init(void);
 extern void sysmem_shutdown(void);
-extern void *sysmem_push(size_t);
+extern void *sysmem_push(size_t, sysmem_tag_t);
 extern void sysmem_pop(void *);
+extern void sysmem_initStack(sysmem_stack_t *, void *, size_t);
+extern void sysmem_freeStack(const sysmem_stack_t *);
+extern sysmem_stack_t *sysmem_setStack(sysmem_stack_t *);
+extern void sysmem_mark(sysmem_mark_t *, const char *);
+extern void sysmem_release(const sysmem_mark_t *);
+extern const sysmem_usage_t *sysmem_getUsage(sysmem_tag_t);
 
 /*
  * video section
@@ -87,6 +140,9 @@ extern void sysmem_pop(void *);
 #define SYSVID_HEIGHT 200
 
 extern U8 *sysvid_fb;  /* frame buffer */
+#ifdef ENABLE_NULL_SYSTEM
+extern U32 sysvid_frames;  /* number of frames presented so far */
+#endif
 
 extern bool sysvid_init(void);
 extern void sysvid_shutdown(void);
@@ -96,6 +152,11 @@ extern void sysvid_zoom(S8);
 extern void sysvid_toggleFullscreen(void);
 extern void sysvid_setGamePalette(void);
 extern void sysvid_setPalette(img_color_t *, U16);
+#ifdef ENABLE_PRESENTER
+extern void sysvid_wait(void);  /* wait for the presenter thread to be done with the screen */
+#else
+#define sysvid_wait()
+#endif
 
 /*
  * file management section
@@ -152,19 +213,116 @@ extern void syssnd_stopAll(void);
 /*
  * args section
  */
+
+/* --map and --submap ranges, checked before the data is loaded.
+ * TODO: check against map_nbr_maps and map_nbr_submaps once loaded. */
+#define SYSARG_NBR_MAPS (5/*MAP_NBR_MAPS*/-1)
+#define SYSARG_NBR_SUBMAPS 47/*MAP_NBR_SUBMAPS*/
+
 extern int sysarg_args_period;
+extern int sysarg_args_turbo;  /* game steps per frame displayed, 0 for adaptive */
 extern int sysarg_args_map;
 extern int sysarg_args_submap;
 extern int sysarg_args_fullscreen;
 extern int sysarg_args_zoom;
+extern int sysarg_args_depth;  /* bits per pixel of the display, 0 for default */
+extern int sysarg_args_memory;  /* main memory stack size (KB), 0 for default */
 #ifdef ENABLE_SOUND
 extern bool sysarg_args_nosound;
 extern int sysarg_args_vol;
 #endif /* ENABLE_ SOUND */
 extern const char *sysarg_args_data;
+#ifdef ENABLE_NULL_SYSTEM
+extern U32 sysarg_args_frames;
+#endif
+#ifdef ENABLE_BATCH
+extern U32 sysarg_args_batch;
+extern U32 sysarg_args_threads;
+#endif /* ENABLE_BATCH */
+#ifdef ENABLE_REPLAY
+extern const char *sysarg_args_record;
+extern const char *sysarg_args_replay;
+#endif /* ENABLE_REPLAY */
+#ifdef ENABLE_OBSERVE
+extern const char *sysarg_args_observe;
+#endif /* ENABLE_OBSERVE */
 
 extern bool sysarg_init(int, char **);
 
+/*
+ * record/replay section
+ */
+#ifdef ENABLE_REPLAY
+extern bool sysrec_replaying;  /* input comes from a recording (true, false) */
+extern U32 sysrec_seed;  /* random seed the recorded game starts from */
+
+extern bool sysrec_init(void);
+extern void sysrec_shutdown(void);
+extern void sysrec_update(void);
+#endif /* ENABLE_REPLAY */
+
+/*
+ * observation export section
+ */
+#ifdef ENABLE_OBSERVE
+extern bool sysobs_init(void);
+extern void sysobs_shutdown(void);
+extern void sysobs_update(void);
+#endif /* ENABLE_OBSERVE */
+
+/*
+ * profiler section
+ *
+ * SYSPROF(phase, statement) runs statement and, when the profiler is
+ * enabled, records how long it took. sysprof_time is always available.
+ */
+extern U32 sysprof_time(void);  /* nanoseconds, wraps around */
+
+#ifdef ENABLE_PROFILER
+typedef enum {
+    SYSPROF_ENT_ACTION,
+    SYSPROF_ENT_DRAW,
+    SYSPROF_DRAW_MAP,
+    SYSPROF_DRAW_STATUS,
+    SYSPROF_SCROLL_UP,
+    SYSPROF_SCROLL_DOWN,
+    SYSPROF_VIDEO,
+    SYSPROF_EVENTS,
+    SYSPROF_NBR_PHASES
+} sysprof_phase_t;
+
+extern void sysprof_add(sysprof_phase_t, U32);
+extern void sysprof_dump(void);
+
+#define SYSPROF(P, X) do { U32 sysprof_t0 = sysprof_time(); X; sysprof_add(P, sysprof_time() - sysprof_t0); } while (0)
+#else
+#define SYSPROF(P, X) X
+#endif /* ENABLE_PROFILER */
+
+/*
+ * thread pool section
+ */
+#ifdef ENABLE_BATCH
+typedef void (*syspool_task_t)(void *, U32);
+
+extern U32 syspool_threads;  /* number of threads, including the calling one */
+
+extern bool syspool_init(U32);
+extern void syspool_shutdown(void);
+extern void syspool_run(syspool_task_t, void *, U32);
+#endif /* ENABLE_BATCH */
+
+/*
+ * batch section
+ */
+#ifdef ENABLE_BATCH
+extern U32 sysbatch_games;  /* number of games run side by side */
+extern U8 *sysbatch_fbs;  /* frame buffers of all games, one after the other */
+extern struct ent_s *sysbatch_ents;  /* entity tables of all games, one after the other */
+
+extern void sysbatch_run(void);
+#endif /* ENABLE_BATCH */
+
 /*
  * joystick section
  */
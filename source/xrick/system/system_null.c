@@ -0,0 +1,216 @@
+/*
+ * xrick/system/system_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Null system: no display, no sound device, no input and no wall-clock
+ * pacing. Time is simulated: each call to sys_sleep advances the clock
+ * by the time slept, hence game_run steps frames back to back, and
+ * everything relying on sys_gettime (screen timeouts...) still behaves
+ * as it would at normal speed.
+ */
+
+#include "xrick/system/system.h"
+#include "xrick/config.h"
+#include "xrick/game.h"
+
+#include <stdarg.h>   /* args */
+#include <stdio.h>    /* printf */
+#include <string.h>   /* strlen */
+#include <time.h>     /* clock */
+
+/*
+ * Local variables
+ */
+static char stringBuffer[2048];
+static U32 simulatedTime = 0;
+static clock_t startClock;
+
+/*
+ * Error
+ */
+void
+sys_error(const char *err, ...)
+{
+    va_list argptr;
+
+    /* prepare message */
+    va_start(argptr, err);
+    vsnprintf(stringBuffer, sizeof(stringBuffer), err, argptr);
+    va_end(argptr);
+
+    /* print error message */
+    fprintf(stderr, "%s\nError!\n", stringBuffer);
+}
+
+/*
+* Print a message to standard output
+*/
+void
+sys_printf(const char *msg, ...)
+{
+    va_list argptr;
+
+    /* prepare message */
+    va_start(argptr, msg);
+    vsnprintf(stringBuffer, sizeof(stringBuffer), msg, argptr);
+    va_end(argptr);
+
+    /* print message */
+    printf("%s", stringBuffer);
+}
+
+/*
+ * Print a message to string buffer
+ */
+void
+sys_snprintf(char *buf, size_t size, const char *msg, ...)
+{
+    va_list argptr;
+
+    va_start(argptr, msg);
+    vsnprintf(buf, size, msg, argptr);
+    va_end(argptr);
+}
+
+/*
+ * Returns string length
+ */
+size_t
+sys_strlen(const char * str)
+{
+    return strlen(str);
+}
+
+/*
+ * Return number of (simulated) milliseconds elapsed since start
+ */
+U32
+sys_gettime(void)
+{
+    return simulatedTime;
+}
+
+/*
+ * Sleep
+ *
+ * Nothing to wait for: jump straight to the end of the sleep.
+ */
+void
+sys_sleep(U32 ms)
+{
+    simulatedTime += ms;
+}
+
+/*
+ * Initialize system
+ */
+bool
+sys_init(int argc, char **argv)
+{
+    if (!sysarg_init(argc, argv))
+    {
+        return false;
+    }
+    if (!sysmem_init())
+    {
+        return false;
+    }
+    if (!sysvid_init())
+    {
+        return false;
+    }
+#ifdef ENABLE_SOUND
+    if (!sysarg_args_nosound && !syssnd_init())
+    {
+        return false;
+    }
+#endif
+    if (!sysfile_setRootPath(sysarg_args_data? sysarg_args_data : sysfile_defaultPath))
+    {
+        return false;
+    }
+#ifdef ENABLE_REPLAY
+    if (!sysrec_init())
+    {
+        return false;
+    }
+#endif
+#ifdef ENABLE_OBSERVE
+    if (!sysobs_init())
+    {
+        return false;
+    }
+#endif
+    simulatedTime = 0;
+    startClock = clock();
+    return true;
+}
+
+/*
+ * Shutdown system
+ */
+void
+sys_shutdown(void)
+{
+    double seconds = (double)(clock() - startClock) / CLOCKS_PER_SEC;
+
+    if (sysvid_frames)
+    {
+        sys_printf("xrick/null: %u frames (%u ms of game time) in %.3f s of cpu time",
+                   sysvid_frames, game_time, seconds);
+        if (seconds > 0)
+        {
+            sys_printf(", %.1f frames per second", sysvid_frames / seconds);
+        }
+        sys_printf("\n");
+    }
+
+#ifdef ENABLE_PROFILER
+    sysprof_dump();
+#endif
+#ifdef ENABLE_REPLAY
+    sysrec_shutdown();
+#endif
+#ifdef ENABLE_OBSERVE
+    sysobs_shutdown();
+#endif
+    sysfile_clearRootPath();
+#ifdef ENABLE_SOUND
+    syssnd_shutdown();
+#endif
+    sysvid_shutdown();
+    sysmem_shutdown();
+}
+
+/*
+ * Preload data before entering main loop
+ */
+bool
+sys_cacheData(void)
+{
+    return true;
+}
+
+/*
+ * Clear preloaded data before shutdown
+ */
+void
+sys_uncacheData(void)
+{
+}
+
+/* eof */
@@ -124,11 +124,20 @@ U32 sys_gettime(void)
 }
 
 /*
-* Yield execution to another thread
+* Sleep, letting other threads run
 */
-void sys_yield(void)
+void sys_sleep(U32 ms)
 {
-    rb->yield();
+    long ticks = (long)ms * HZ / 1000;
+
+    if (ticks > 0)
+    {
+        rb->sleep(ticks);
+    }
+    else
+    {
+        rb->yield();
+    }
 }
 
 /*
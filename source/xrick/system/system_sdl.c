@@ -116,13 +116,12 @@ sys_gettime(void)
 }
 
 /*
- * Yield execution to another thread
+ * Sleep, letting other threads run
  */
 void
-sys_yield(void)
+sys_sleep(U32 ms)
 {
-    /* Be nice to the OS by sleeping for 1 ms. */
-    SDL_Delay(1);
+    SDL_Delay(ms);
 }
 
 /*
@@ -159,6 +158,18 @@ sys_init(int argc, char **argv)
     {
         return false;
     }
+#ifdef ENABLE_REPLAY
+    if (!sysrec_init())
+    {
+        return false;
+    }
+#endif
+#ifdef ENABLE_OBSERVE
+    if (!sysobs_init())
+    {
+        return false;
+    }
+#endif
     return true;
 }
 
@@ -168,6 +179,15 @@ sys_init(int argc, char **argv)
 void
 sys_shutdown(void)
 {
+#ifdef ENABLE_PROFILER
+    sysprof_dump();
+#endif
+#ifdef ENABLE_REPLAY
+    sysrec_shutdown();
+#endif
+#ifdef ENABLE_OBSERVE
+    sysobs_shutdown();
+#endif
     sysfile_clearRootPath();
 #ifdef ENABLE_SOUND
     syssnd_shutdown();
@@ -0,0 +1,137 @@
+/*
+ * xrick/system/sysvid_null.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Null video: the game still draws into sysvid_fb, but nothing is ever
+ * presented. sysvid_update only counts frames.
+ */
+
+#include "xrick/system/system.h"
+#include "xrick/draw.h"
+#include "xrick/debug.h"
+
+#include <string.h> /* memset */
+#include <stdlib.h> /* malloc */
+
+/*
+ * Global variables
+ */
+U8 *sysvid_fb = NULL; /* frame buffer */
+U32 sysvid_frames = 0; /* frames presented */
+
+/*
+ * Local variables
+ */
+static bool isVideoInitialised = false;
+
+/*
+ *
+ */
+void sysvid_setPalette(img_color_t *pal/*unused*/, U16 n/*unused*/)
+{
+    (void)pal;
+    (void)n;
+}
+
+/*
+ *
+ */
+void sysvid_setGamePalette()
+{
+    sysvid_setPalette(game_colors, game_color_count);
+}
+
+/*
+ * Initialise video
+ */
+bool
+sysvid_init(void)
+{
+    if (isVideoInitialised)
+    {
+        return true;
+    }
+
+    IFDEBUG_VIDEO(sys_printf("xrick/video: start\n"););
+
+    sysvid_fb = malloc(SYSVID_WIDTH * SYSVID_HEIGHT);
+    if (!sysvid_fb)
+    {
+        sys_error("(video) sysvid_fb malloc failed");
+        return false;
+    }
+    sysvid_frames = 0;
+
+    isVideoInitialised = true;
+    IFDEBUG_VIDEO(sys_printf("xrick/video: ready\n"););
+    return true;
+}
+
+/*
+ * Shutdown video
+ */
+void
+sysvid_shutdown(void)
+{
+    if (!isVideoInitialised)
+    {
+        return;
+    }
+
+    free(sysvid_fb);
+    sysvid_fb = NULL;
+    isVideoInitialised = false;
+    IFDEBUG_VIDEO(sys_printf("xrick/video: stop\n"););
+}
+
+/*
+ * Update screen
+ */
+void
+sysvid_update(const rect_t *rects/*unused*/)
+{
+    (void)rects;
+    sysvid_frames++;
+}
+
+/*
+ * Clear screen
+ */
+void
+sysvid_clear(void)
+{
+    memset(sysvid_fb, 0, SYSVID_WIDTH * SYSVID_HEIGHT);
+}
+
+/*
+ * Zoom
+ */
+void
+sysvid_zoom(S8 z/*unused*/)
+{
+    (void)z;
+}
+
+/*
+ * Toggle fullscreen
+ */
+void
+sysvid_toggleFullscreen(void)
+{
+}
+
+/* eof */
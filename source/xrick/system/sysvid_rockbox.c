@@ -154,6 +154,13 @@ void sysvid_update(const rect_t *rects)
 
     while (rects)
     {
+        if (rects_isEmpty(rects))
+        {
+            /* merged into another rectangle */
+            rects = rects->next;
+            continue;
+        }
+
         sourceRow = rects->y;
         sourceLastRow = sourceRow + rects->height;
         sourceColumn = rects->x;
@@ -304,7 +311,7 @@ bool sysvid_init()
     do
     {
         /* allocate xRick generic frame buffer into memory */
-        sysvid_fb = sysmem_push(sizeof(U8) * SYSVID_WIDTH * SYSVID_HEIGHT);
+        sysvid_fb = sysmem_push(sizeof(U8) * SYSVID_WIDTH * SYSVID_HEIGHT, SYSMEM_TAG_VIDEO);
         if (!sysvid_fb)
         {
             sys_error("(video) unable to allocate frame buffer");
@@ -312,7 +319,7 @@ bool sysvid_init()
         }
 
 #ifndef HAVE_LCD_COLOR
-        gbuf = sysmem_push(GREYBUFSIZE);
+        gbuf = sysmem_push(GREYBUFSIZE, SYSMEM_TAG_VIDEO);
         if (!gbuf)
         {
             sys_error("(video) unable to allocate buffer for greyscale functions");
@@ -19,8 +19,9 @@
 #include "xrick/data/img.h"
 #include "xrick/debug.h"
 #include "xrick/system/system.h"
+#include "xrick/unpack.h"
 
-#include <string.h> /* memset */
+#include <string.h> /* memset, memcpy */
 #include <stdlib.h> /* malloc */
 #include <SDL.h>
 
@@ -29,20 +30,58 @@
  */
 U8 *sysvid_fb; /* frame buffer */
 
+enum { UPDATE_RECTS_MAX = 64 };  /* rectangles per SDL_UpdateRects call */
+
 /*
  * Local variables
  */
 static SDL_Color palette[256];
+static U32 lut[256];  /* palette, as pixels of a 32 bits screen */
 static SDL_Surface *screen;
 static U32 videoFlags;
+static U8 depth = 8;  /* screen bits per pixel, 8 (palette) or 32 */
 static bool isVideoInitialised = false;
 
 static U8 zoom = SYSVID_ZOOM; /* actual zoom level */
 static U8 szoom = 0;  /* saved zoom level */
 static U8 fszoom = 0;  /* fullscreen zoom level */
 
+#ifdef ENABLE_PRESENTER
+/*
+ * Presenter thread
+ *
+ * sysvid_update copies the rectangles to update from sysvid_fb to
+ * presentFb, hands their list over to the presenter thread, and returns:
+ * upscaling and presenting then overlap with the next game step. The game
+ * keeps drawing into sysvid_fb, which is only ever updated incrementally,
+ * hence the copy rather than a swap of buffers.
+ *
+ * There is at most one frame in flight: sysvid_update first waits for the
+ * previous one to be presented. Anything else touching the screen or the
+ * palette (zoom, fullscreen, palette changes) waits too, then presents the
+ * screen itself, right away. So do event polls, since SDL video and events
+ * must not be used by two threads at once: game_run polls before handing
+ * a frame over, not after, and the screen changes made while handling
+ * events leave no frame in flight.
+ */
+static SDL_Thread *presenter = NULL;
+static SDL_mutex *presentLock = NULL;
+static SDL_cond *presentCond = NULL;
+static bool presentPending = false;  /* a frame is waiting to be presented */
+static bool presentQuit = false;  /* presenter thread must exit */
+static bool presentFailed = false;  /* presenting failed, the game must exit */
+static U8 *presentFb = NULL;  /* copy of sysvid_fb rectangles */
+static rect_t presentRects[UPDATE_RECTS_MAX];
+#endif
+
 #include "xrick/system/sdl_icon.e"
 
+static bool sysvid_present(const U8 *, const rect_t *);
+#ifdef ENABLE_PRESENTER
+static void sysvid_startPresenter(void);
+static void sysvid_stopPresenter(void);
+#endif
+
 /*
  * Initialize screen
  */
@@ -51,11 +90,36 @@ static SDL_Surface *initScreen(U16 w, U16 h, U8 bpp, U32 flags)
     return SDL_SetVideoMode(w, h, bpp, flags);
 }
 
+/*
+ * Convert palette colors to pixels of the 32 bits screen
+ *
+ * return: true if any pixel changed
+ */
+static bool sysvid_mapPalette(U16 n)
+{
+    U16 i;
+    U32 pixel;
+    bool changed = false;
+
+    for (i = 0; i < n; i++)
+    {
+        pixel = SDL_MapRGB(screen->format, palette[i].r, palette[i].g, palette[i].b);
+        changed |= (pixel != lut[i]);
+        lut[i] = pixel;
+    }
+    return changed;
+}
+
 /*
  *
  */
 static void sysvid_restorePalette()
 {
+    if (depth == 32)
+    {
+        sysvid_mapPalette(256);  /* screen format may have changed */
+        return;
+    }
     SDL_SetColors(screen, (SDL_Color *)&palette, 0, 256);
 }
 
@@ -66,12 +130,22 @@ void sysvid_setPalette(img_color_t *pal, U16 n)
 {
     U16 i;
 
+    sysvid_wait();
     for (i = 0; i < n; i++)
     {
         palette[i].r = pal[i].r;
         palette[i].g = pal[i].g;
         palette[i].b = pal[i].b;
     }
+    if (depth == 32)
+    {
+        /* no hardware palette: what is on screen must be redrawn */
+        if (sysvid_mapPalette(n) && !sysvid_present(sysvid_fb, &draw_SCREENRECT))
+        {
+            control_set(Control_EXIT);
+        }
+        return;
+    }
     SDL_SetColors(screen, (SDL_Color *)&palette, 0, n);
 }
 
@@ -200,7 +274,16 @@ sysvid_init(void)
     SDL_WM_SetIcon(icon, NULL);
 
     /* video modes and screen */
-    videoFlags = SDL_HWSURFACE|SDL_HWPALETTE;
+    if (sysarg_args_depth)
+    {
+        depth = sysarg_args_depth;
+    }
+    else
+    {
+        /* a palette would then be converted to 32 bits by SDL, each frame */
+        depth = (SDL_GetVideoInfo()->vfmt->BitsPerPixel == 32) ? 32 : 8;
+    }
+    videoFlags = (depth == 8) ? SDL_HWSURFACE|SDL_HWPALETTE : SDL_HWSURFACE;
     if (!sysvid_chkvm()) /* check video modes */
     {
         SDL_Quit();
@@ -216,7 +299,7 @@ sysvid_init(void)
         szoom = zoom;
         zoom = fszoom;
     }
-    screen = initScreen(SYSVID_WIDTH * zoom, SYSVID_HEIGHT * zoom, 8, videoFlags);
+    screen = initScreen(SYSVID_WIDTH * zoom, SYSVID_HEIGHT * zoom, depth, videoFlags);
 
     /*
     * create v_ frame buffer
@@ -229,6 +312,10 @@ sysvid_init(void)
         return false;
     }
 
+#ifdef ENABLE_PRESENTER
+    sysvid_startPresenter();
+#endif
+
     isVideoInitialised = true;
     IFDEBUG_VIDEO(sys_printf("xrick/video: ready\n"););
     return true;
@@ -245,6 +332,9 @@ sysvid_shutdown(void)
         return;
     }
 
+#ifdef ENABLE_PRESENTER
+    sysvid_stopPresenter();
+#endif
     free(sysvid_fb);
     SDL_Quit();
     isVideoInitialised = false;
@@ -252,74 +342,277 @@ sysvid_shutdown(void)
 }
 
 /*
- * Update screen
- * NOTE errors processing ?
+ * Present frame buffer rectangles on screen
+ *
+ * Rectangles are first copied to the locked surface, then the screen is
+ * updated with one SDL_UpdateRects call for all of them. On a 32 bits
+ * screen, pixels are converted through the palette while being copied.
+ *
+ * fb: frame buffer, SYSVID_WIDTH by SYSVID_HEIGHT pixels
+ * rects: rectangles to present, NULL if none
+ * return: false if the screen could not be locked, then the game must exit;
+ *   this may run on the presenter thread, hence not setting Control_EXIT.
  */
-void
-sysvid_update(const rect_t *rects)
+static bool
+sysvid_present(const U8 *fb, const rect_t *rects)
 {
-  static SDL_Rect area;
-  U16 x, y, xz, yz;
-  U8 *p, *q, *p0, *q0;
+  static SDL_Rect areas[UPDATE_RECTS_MAX];
+  const rect_t *r;
+  U16 y, yz, n, bytes;
+  const U8 *p0;
+  U8 *q0;
 
   if (rects == NULL)
-    return;
+    return true;
 
   if (SDL_LockSurface(screen) == -1)
   {
     sys_error("(video): SDL_LockSurface failed");
-    control_set(Control_EXIT);
-    return;
+    return false;
   }
 
-  while (rects) {
-    p0 = sysvid_fb;
-    p0 += rects->x + rects->y * SYSVID_WIDTH;
+  bytes = screen->format->BytesPerPixel;
+  for (r = rects; r; r = r->next) {
+    if (rects_isEmpty(r))
+      continue;  /* merged into another rectangle */
+
+    p0 = fb;
+    p0 += r->x + r->y * SYSVID_WIDTH;
     q0 = (U8 *)screen->pixels;
-    q0 += (rects->x + rects->y * SYSVID_WIDTH * zoom) * zoom;
-
-    for (y = rects->y; y < rects->y + rects->height; y++) {
-      for (yz = 0; yz < zoom; yz++) {
-    p = p0;
-    q = q0;
-    for (x = rects->x; x < rects->x + rects->width; x++) {
-      for (xz = 0; xz < zoom; xz++) {
-        *q = *p;
-        q++;
-      }
-      p++;
-    }
-    q0 += SYSVID_WIDTH * zoom;
-      }
+    q0 += r->x * zoom * bytes + r->y * zoom * screen->pitch;
+
+    for (y = r->y; y < r->y + r->height; y++) {
+      /* widen the row, then copy it to the zoom - 1 rows below */
+      if (depth == 32)
+    unpack_widenLut((U32 *)q0, p0, r->width, zoom, lut);
+      else
+    unpack_widen(q0, p0, r->width, zoom);
+      for (yz = 1; yz < zoom; yz++)
+    memcpy(q0 + yz * screen->pitch, q0, r->width * zoom * bytes);
+      q0 += screen->pitch * zoom;
       p0 += SYSVID_WIDTH;
     }
 
     IFDEBUG_VIDEO2(
-    for (y = rects->y; y < rects->y + rects->height; y++)
-      for (yz = 0; yz < zoom; yz++) {
-    p = (U8 *)screen->pixels + rects->x * zoom + (y * zoom + yz) * SYSVID_WIDTH * zoom;
+    U16 x;
+    U16 w;
+    U16 h;
+    U8 *p;
+
+    /* outline the rectangle with color 1 */
+    w = r->width * zoom;
+    h = r->height * zoom;
+    q0 = (U8 *)screen->pixels;
+    q0 += r->x * zoom * bytes + r->y * zoom * screen->pitch;
+
+    for (y = 0; y < h; y++) {
+      p = q0 + y * screen->pitch;
+      if (depth == 32) {
+    *(U32 *)p = lut[1];
+    *(U32 *)(p + (w - 1) * bytes) = lut[1];
+      }
+      else {
     *p = 0x01;
-    *(p + rects->width * zoom - 1) = 0x01;
+    *(p + w - 1) = 0x01;
       }
+    }
 
-    for (x = rects->x; x < rects->x + rects->width; x++)
-      for (xz = 0; xz < zoom; xz++) {
-    p = (U8 *)screen->pixels + x * zoom + xz + rects->y * zoom * SYSVID_WIDTH * zoom;
+    for (x = 0; x < w; x++) {
+      p = q0 + x * bytes;
+      if (depth == 32) {
+    *(U32 *)p = lut[1];
+    *(U32 *)(p + (h - 1) * screen->pitch) = lut[1];
+      }
+      else {
     *p = 0x01;
-    *(p + ((rects->height * zoom - 1) * zoom) * SYSVID_WIDTH) = 0x01;
+    *(p + (h - 1) * screen->pitch) = 0x01;
       }
+    }
     );
+  }
 
-    area.x = rects->x * zoom;
-    area.y = rects->y * zoom;
-    area.h = rects->height * zoom;
-    area.w = rects->width * zoom;
-    SDL_UpdateRects(screen, 1, &area);
+  SDL_UnlockSurface(screen);
 
-    rects = rects->next;
+  /* SDL_UpdateRects must not be called while the surface is locked */
+  n = 0;
+  for (r = rects; r; r = r->next) {
+    if (rects_isEmpty(r))
+      continue;
+    areas[n].x = r->x * zoom;
+    areas[n].y = r->y * zoom;
+    areas[n].h = r->height * zoom;
+    areas[n].w = r->width * zoom;
+    if (++n == UPDATE_RECTS_MAX) {
+      SDL_UpdateRects(screen, n, areas);
+      n = 0;
+    }
   }
+  if (n)
+    SDL_UpdateRects(screen, n, areas);
+  return true;
+}
 
-  SDL_UnlockSurface(screen);
+
+#ifdef ENABLE_PRESENTER
+/*
+ * Presenter thread: present frames as sysvid_update hands them over
+ */
+static int
+sysvid_presenter(void *unused)
+{
+  bool presented;
+
+  (void)unused;
+
+  SDL_mutexP(presentLock);
+  for (;;) {
+    while (!presentPending && !presentQuit)
+      SDL_CondWait(presentCond, presentLock);
+    if (presentQuit)
+      break;
+    SDL_mutexV(presentLock);
+
+    presented = sysvid_present(presentFb, presentRects);
+
+    SDL_mutexP(presentLock);
+    presentFailed |= !presented;  /* see sysvid_wait */
+    presentPending = false;
+    SDL_CondBroadcast(presentCond);
+  }
+  SDL_mutexV(presentLock);
+  return 0;
+}
+
+
+/*
+ * Wait for the presenter thread to be done with the frame in flight
+ *
+ * If presenting failed, the game is told to exit from here, on the game
+ * thread: game_ctx is thread local, the presenter thread has none.
+ */
+void
+sysvid_wait(void)
+{
+  bool failed;
+
+  if (!presenter)
+    return;
+  SDL_mutexP(presentLock);
+  while (presentPending)
+    SDL_CondWait(presentCond, presentLock);
+  failed = presentFailed;
+  presentFailed = false;
+  SDL_mutexV(presentLock);
+  if (failed)
+    control_set(Control_EXIT);
+}
+
+
+/*
+ * Start the presenter thread, or leave frames to be presented directly
+ */
+static void
+sysvid_startPresenter(void)
+{
+  presentFb = malloc(SYSVID_WIDTH * SYSVID_HEIGHT);
+  presentLock = SDL_CreateMutex();
+  presentCond = SDL_CreateCond();
+  presentQuit = false;
+  presentPending = false;
+  presentFailed = false;
+  if (presentFb && presentLock && presentCond)
+    presenter = SDL_CreateThread(sysvid_presenter, NULL);
+  if (presenter)
+    return;
+
+  IFDEBUG_VIDEO(sys_printf("xrick/video: no presenter thread\n"););
+  if (presentCond) SDL_DestroyCond(presentCond);
+  if (presentLock) SDL_DestroyMutex(presentLock);
+  free(presentFb);
+  presentCond = NULL;
+  presentLock = NULL;
+  presentFb = NULL;
+}
+
+
+/*
+ * Stop the presenter thread, once the frame in flight is presented
+ */
+static void
+sysvid_stopPresenter(void)
+{
+  if (!presenter)
+    return;
+  sysvid_wait();
+  SDL_mutexP(presentLock);
+  presentQuit = true;
+  SDL_CondBroadcast(presentCond);
+  SDL_mutexV(presentLock);
+  SDL_WaitThread(presenter, NULL);
+  presenter = NULL;
+
+  SDL_DestroyCond(presentCond);
+  SDL_DestroyMutex(presentLock);
+  free(presentFb);
+  presentCond = NULL;
+  presentLock = NULL;
+  presentFb = NULL;
+}
+#endif /* ENABLE_PRESENTER */
+
+
+/*
+ * Update screen
+ *
+ * With the presenter thread, the rectangles are copied and handed over to
+ * it, else they are presented right away.
+ */
+void
+sysvid_update(const rect_t *rects)
+{
+#ifdef ENABLE_PRESENTER
+  const rect_t *r;
+  U16 n, y;
+
+  if (rects == NULL)
+    return;
+  if (!presenter) {
+    if (!sysvid_present(sysvid_fb, rects))
+      control_set(Control_EXIT);
+    return;
+  }
+
+  sysvid_wait();
+
+  /* copy the list, then the pixels, the whole screen if too many rects */
+  for (n = 0, r = rects; r && n < UPDATE_RECTS_MAX; r = r->next) {
+    if (rects_isEmpty(r))
+      continue;
+    presentRects[n] = *r;
+    presentRects[n].next = &presentRects[n + 1];
+    n++;
+  }
+  if (r) {
+    presentRects[0] = draw_SCREENRECT;
+    n = 1;
+  }
+  if (n == 0)
+    return;
+  presentRects[n - 1].next = NULL;
+
+  for (r = presentRects; r; r = r->next)
+    for (y = r->y; y < r->y + r->height; y++)
+      memcpy(presentFb + r->x + y * SYSVID_WIDTH,
+             sysvid_fb + r->x + y * SYSVID_WIDTH, r->width);
+
+  SDL_mutexP(presentLock);
+  presentPending = true;
+  SDL_CondSignal(presentCond);
+  SDL_mutexV(presentLock);
+#else
+  if (!sysvid_present(sysvid_fb, rects))
+    control_set(Control_EXIT);
+#endif
 }
 
 
@@ -343,12 +636,14 @@ sysvid_zoom(S8 z)
   if (!(videoFlags & SDL_FULLSCREEN) &&
       ((z < 0 && zoom > 1) ||
        (z > 0 && zoom < SYSVID_MAXZOOM))) {
+    sysvid_wait();
     zoom += z;
     screen = initScreen(SYSVID_WIDTH * zoom,
             SYSVID_HEIGHT * zoom,
             screen->format->BitsPerPixel, videoFlags);
     sysvid_restorePalette();
-    sysvid_update(&draw_SCREENRECT);
+    if (!sysvid_present(sysvid_fb, &draw_SCREENRECT))
+      control_set(Control_EXIT);
   }
 }
 
@@ -358,6 +653,7 @@ sysvid_zoom(S8 z)
 void
 sysvid_toggleFullscreen(void)
 {
+  sysvid_wait();
   videoFlags ^= SDL_FULLSCREEN;
 
   if (videoFlags & SDL_FULLSCREEN) {  /* go fullscreen */
@@ -371,7 +667,8 @@ sysvid_toggleFullscreen(void)
               SYSVID_HEIGHT * zoom,
               screen->format->BitsPerPixel, videoFlags);
   sysvid_restorePalette();
-  sysvid_update(&draw_SCREENRECT);
+  if (!sysvid_present(sysvid_fb, &draw_SCREENRECT))
+    control_set(Control_EXIT);
 }
 
 /* eof */
@@ -0,0 +1,593 @@
+/*
+ * xrick/unpack.c
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+/*
+ * NOTES
+ *
+ * Each conversion has a scalar kernel, plus SSE2 (x86) or NEON (ARM) kernels
+ * when ENABLE_SIMD is defined and the compiler supports them. The SIMD
+ * kernels process 4 (nibbles) or 8 (crumbs) words, or 16 (widen) or 4
+ * (widenLut) pixels at a time, and leave what remains to the scalar kernel.
+ * They assume a little-endian CPU.
+ *
+ * Widening has one kernel per zoom level. On x86, widening by 3 needs the
+ * SSSE3 byte shuffle, and uses the scalar kernel on CPUs without SSSE3.
+ *
+ * The function pointers initially point to resolvers, which check what the
+ * CPU supports, point the function pointers to the best kernels, and call
+ * them.
+ */
+
+#include "xrick/unpack.h"
+#include "xrick/config.h"
+
+#include <string.h> /* memcpy */
+
+#ifdef ENABLE_SIMD
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define UNPACK_SSE2
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#include <emmintrin.h>
+#include <tmmintrin.h>  /* _mm_shuffle_epi8 */
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define UNPACK_SSE2
+#define SSE2_TARGET
+#define SSSE3_TARGET
+#include <emmintrin.h>
+#include <tmmintrin.h>  /* _mm_shuffle_epi8 */
+#include <intrin.h>     /* __cpuid */
+#elif defined(__ARM_NEON) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define UNPACK_NEON
+#include <arm_neon.h>
+#if defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>   /* getauxval */
+#include <asm/hwcap.h>  /* HWCAP_NEON */
+#endif
+#endif
+#endif /* ENABLE_SIMD */
+
+static void resolveNibbles(U8 *dst, const U32 *src, size_t count);
+static void resolveCrumbs(U8 *dst, const U16 *src, size_t count, U16 filter);
+static void resolveWiden(U8 *dst, const U8 *src, size_t count, U8 zoom);
+static void resolveWidenLut(U32 *dst, const U8 *src, size_t count, U8 zoom, const U32 *lut);
+
+/*
+ * Global variables
+ */
+unpack_nibbles_t unpack_nibbles = resolveNibbles;
+unpack_crumbs_t unpack_crumbs = resolveCrumbs;
+unpack_widen_t unpack_widen = resolveWiden;
+unpack_widenLut_t unpack_widenLut = resolveWidenLut;
+const char *unpack_kernels = "scalar";
+
+/*
+ * Scalar kernels
+ */
+static void
+unpackNibblesScalar(U8 *dst, const U32 *src, size_t count)
+{
+    size_t i;
+    U8 k;
+
+    for (i = 0; i < count; i++, dst += 8)
+    {
+        U32 x = src[i];
+        for (k = 8; k--; x >>= 4)
+        {
+            dst[k] = x & 0x0f;
+        }
+    }
+}
+
+static void
+unpackCrumbsScalar(U8 *dst, const U16 *src, size_t count, U16 filter)
+{
+    size_t i;
+    U8 k;
+
+    for (i = 0; i < count; i++, dst += 8)
+    {
+        U16 x = src[i] & filter;
+        for (k = 8; k--; x >>= 2)
+        {
+            dst[k] = x & 3;
+        }
+    }
+}
+
+static void
+widenScalar(U8 *dst, const U8 *src, size_t count, U8 zoom)
+{
+    size_t i;
+
+    switch (zoom)
+    {
+    case 1:
+        memcpy(dst, src, count);
+        break;
+    case 2:
+        for (i = 0; i < count; i++, dst += 2)
+        {
+            dst[0] = dst[1] = src[i];
+        }
+        break;
+    case 3:
+        for (i = 0; i < count; i++, dst += 3)
+        {
+            dst[0] = dst[1] = dst[2] = src[i];
+        }
+        break;
+    case 4:
+        for (i = 0; i < count; i++, dst += 4)
+        {
+            dst[0] = dst[1] = dst[2] = dst[3] = src[i];
+        }
+        break;
+    }
+}
+
+static void
+widenLutScalar(U32 *dst, const U8 *src, size_t count, U8 zoom, const U32 *lut)
+{
+    size_t i;
+
+    switch (zoom)
+    {
+    case 1:
+        for (i = 0; i < count; i++)
+        {
+            dst[i] = lut[src[i]];
+        }
+        break;
+    case 2:
+        for (i = 0; i < count; i++, dst += 2)
+        {
+            dst[0] = dst[1] = lut[src[i]];
+        }
+        break;
+    case 3:
+        for (i = 0; i < count; i++, dst += 3)
+        {
+            dst[0] = dst[1] = dst[2] = lut[src[i]];
+        }
+        break;
+    case 4:
+        for (i = 0; i < count; i++, dst += 4)
+        {
+            dst[0] = dst[1] = dst[2] = dst[3] = lut[src[i]];
+        }
+        break;
+    }
+}
+
+/*
+ * SSE2 kernels
+ */
+#ifdef UNPACK_SSE2
+static SSE2_TARGET void
+unpackNibblesSse2(U8 *dst, const U32 *src, size_t count)
+{
+    const __m128i low = _mm_set1_epi8(0x0f);
+    size_t i;
+
+    for (i = 0; i + 4 <= count; i += 4, dst += 32)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i hi, lo;
+
+        /* most significant byte first, within each word */
+        x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1);
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        /* then high nibble first, within each byte */
+        hi = _mm_and_si128(_mm_srli_epi16(x, 4), low);
+        lo = _mm_and_si128(x, low);
+        _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    unpackNibblesScalar(dst, src + i, count - i);
+}
+
+static SSE2_TARGET void
+unpackCrumbsSse2(U8 *dst, const U16 *src, size_t count, U16 filter)
+{
+    const __m128i three = _mm_set1_epi8(3);
+    const __m128i mask = _mm_set1_epi16((short)filter);
+    size_t i;
+
+    for (i = 0; i + 8 <= count; i += 8, dst += 64)
+    {
+        __m128i x = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + i)), mask);
+        __m128i p0, p1, p2, p3, p01, p23;
+
+        /* most significant byte first, within each word */
+        x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+        /* then most significant crumb first, within each byte */
+        p0 = _mm_and_si128(_mm_srli_epi16(x, 6), three);
+        p1 = _mm_and_si128(_mm_srli_epi16(x, 4), three);
+        p2 = _mm_and_si128(_mm_srli_epi16(x, 2), three);
+        p3 = _mm_and_si128(x, three);
+        p01 = _mm_unpacklo_epi8(p0, p1);
+        p23 = _mm_unpacklo_epi8(p2, p3);
+        _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(p01, p23));
+        _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(p01, p23));
+        p01 = _mm_unpackhi_epi8(p0, p1);
+        p23 = _mm_unpackhi_epi8(p2, p3);
+        _mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(p01, p23));
+        _mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(p01, p23));
+    }
+    unpackCrumbsScalar(dst, src + i, count - i, filter);
+}
+
+static SSE2_TARGET void
+widenSse2(U8 *dst, const U8 *src, size_t count, U8 zoom)
+{
+    size_t i = 0;
+
+    switch (zoom)
+    {
+    case 2:
+        for (; i + 16 <= count; i += 16, dst += 32)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+
+            _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(x, x));
+            _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(x, x));
+        }
+        break;
+    case 4:
+        for (; i + 16 <= count; i += 16, dst += 64)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+            __m128i lo = _mm_unpacklo_epi8(x, x);
+            __m128i hi = _mm_unpackhi_epi8(x, x);
+
+            _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(lo, lo));
+            _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi8(lo, lo));
+            _mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi8(hi, hi));
+            _mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi8(hi, hi));
+        }
+        break;
+    }
+    widenScalar(dst, src + i, count - i, zoom);
+}
+
+static SSE2_TARGET __m128i
+lookupSse2(const U8 *src, const U32 *lut)
+{
+    return _mm_setr_epi32((int)lut[src[0]], (int)lut[src[1]], (int)lut[src[2]], (int)lut[src[3]]);
+}
+
+static SSE2_TARGET void
+widenLutSse2(U32 *dst, const U8 *src, size_t count, U8 zoom, const U32 *lut)
+{
+    size_t i = 0;
+
+    switch (zoom)
+    {
+    case 1:
+        for (; i + 4 <= count; i += 4, dst += 4)
+        {
+            _mm_storeu_si128((__m128i *)dst, lookupSse2(src + i, lut));
+        }
+        break;
+    case 2:
+        for (; i + 4 <= count; i += 4, dst += 8)
+        {
+            __m128i x = lookupSse2(src + i, lut);
+
+            _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi32(x, x));
+            _mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi32(x, x));
+        }
+        break;
+    case 3:
+        for (; i + 4 <= count; i += 4, dst += 12)
+        {
+            __m128i x = lookupSse2(src + i, lut);
+
+            _mm_storeu_si128((__m128i *)dst, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 0, 0)));
+            _mm_storeu_si128((__m128i *)(dst + 4), _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 2, 1, 1)));
+            _mm_storeu_si128((__m128i *)(dst + 8), _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 2)));
+        }
+        break;
+    case 4:
+        for (; i + 4 <= count; i += 4, dst += 16)
+        {
+            __m128i x = lookupSse2(src + i, lut);
+
+            _mm_storeu_si128((__m128i *)dst, _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_storeu_si128((__m128i *)(dst + 4), _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_storeu_si128((__m128i *)(dst + 8), _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_storeu_si128((__m128i *)(dst + 12), _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3)));
+        }
+        break;
+    }
+    widenLutScalar(dst, src + i, count - i, zoom, lut);
+}
+
+static SSSE3_TARGET void
+widenSsse3(U8 *dst, const U8 *src, size_t count, U8 zoom)
+{
+    size_t i = 0;
+
+    if (zoom == 3)
+    {
+        const __m128i s0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+        const __m128i s1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+        const __m128i s2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+
+        for (; i + 16 <= count; i += 16, dst += 48)
+        {
+            __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+
+            _mm_storeu_si128((__m128i *)dst, _mm_shuffle_epi8(x, s0));
+            _mm_storeu_si128((__m128i *)(dst + 16), _mm_shuffle_epi8(x, s1));
+            _mm_storeu_si128((__m128i *)(dst + 32), _mm_shuffle_epi8(x, s2));
+        }
+        widenScalar(dst, src + i, count - i, zoom);
+        return;
+    }
+    widenSse2(dst, src, count, zoom);
+}
+
+static bool
+hasSsse3(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static bool
+hasSse2(void)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+#endif /* UNPACK_SSE2 */
+
+/*
+ * NEON kernels
+ */
+#ifdef UNPACK_NEON
+static void
+unpackNibblesNeon(U8 *dst, const U32 *src, size_t count)
+{
+    const uint8x16_t low = vdupq_n_u8(0x0f);
+    size_t i;
+
+    for (i = 0; i + 4 <= count; i += 4, dst += 32)
+    {
+        /* most significant byte first, within each word */
+        uint8x16_t x = vrev32q_u8(vld1q_u8((const uint8_t *)(src + i)));
+        /* then high nibble first, within each byte */
+        uint8x16x2_t p = vzipq_u8(vshrq_n_u8(x, 4), vandq_u8(x, low));
+
+        vst1q_u8(dst, p.val[0]);
+        vst1q_u8(dst + 16, p.val[1]);
+    }
+    unpackNibblesScalar(dst, src + i, count - i);
+}
+
+static void
+unpackCrumbsNeon(U8 *dst, const U16 *src, size_t count, U16 filter)
+{
+    const uint8x16_t three = vdupq_n_u8(3);
+    const uint16x8_t mask = vdupq_n_u16(filter);
+    size_t i;
+
+    for (i = 0; i + 8 <= count; i += 8, dst += 64)
+    {
+        /* most significant byte first, within each word */
+        uint8x16_t x = vrev16q_u8(vreinterpretq_u8_u16(vandq_u16(vld1q_u16(src + i), mask)));
+        uint8x16x4_t p;
+
+        /* then most significant crumb first, within each byte */
+        p.val[0] = vshrq_n_u8(x, 6);
+        p.val[1] = vandq_u8(vshrq_n_u8(x, 4), three);
+        p.val[2] = vandq_u8(vshrq_n_u8(x, 2), three);
+        p.val[3] = vandq_u8(x, three);
+        vst4q_u8(dst, p);
+    }
+    unpackCrumbsScalar(dst, src + i, count - i, filter);
+}
+
+static void
+widenNeon(U8 *dst, const U8 *src, size_t count, U8 zoom)
+{
+    size_t i = 0;
+
+    /* storing n interleaved copies repeats each pixel n times */
+    switch (zoom)
+    {
+    case 2:
+        for (; i + 16 <= count; i += 16, dst += 32)
+        {
+            uint8x16x2_t p;
+
+            p.val[0] = p.val[1] = vld1q_u8(src + i);
+            vst2q_u8(dst, p);
+        }
+        break;
+    case 3:
+        for (; i + 16 <= count; i += 16, dst += 48)
+        {
+            uint8x16x3_t p;
+
+            p.val[0] = p.val[1] = p.val[2] = vld1q_u8(src + i);
+            vst3q_u8(dst, p);
+        }
+        break;
+    case 4:
+        for (; i + 16 <= count; i += 16, dst += 64)
+        {
+            uint8x16x4_t p;
+
+            p.val[0] = p.val[1] = p.val[2] = p.val[3] = vld1q_u8(src + i);
+            vst4q_u8(dst, p);
+        }
+        break;
+    }
+    widenScalar(dst, src + i, count - i, zoom);
+}
+
+static uint32x4_t
+lookupNeon(const U8 *src, const U32 *lut)
+{
+    uint32x4_t x = vdupq_n_u32(lut[src[0]]);
+
+    x = vsetq_lane_u32(lut[src[1]], x, 1);
+    x = vsetq_lane_u32(lut[src[2]], x, 2);
+    return vsetq_lane_u32(lut[src[3]], x, 3);
+}
+
+static void
+widenLutNeon(U32 *dst, const U8 *src, size_t count, U8 zoom, const U32 *lut)
+{
+    size_t i = 0;
+
+    switch (zoom)
+    {
+    case 1:
+        for (; i + 4 <= count; i += 4, dst += 4)
+        {
+            vst1q_u32(dst, lookupNeon(src + i, lut));
+        }
+        break;
+    case 2:
+        for (; i + 4 <= count; i += 4, dst += 8)
+        {
+            uint32x4x2_t p;
+
+            p.val[0] = p.val[1] = lookupNeon(src + i, lut);
+            vst2q_u32(dst, p);
+        }
+        break;
+    case 3:
+        for (; i + 4 <= count; i += 4, dst += 12)
+        {
+            uint32x4x3_t p;
+
+            p.val[0] = p.val[1] = p.val[2] = lookupNeon(src + i, lut);
+            vst3q_u32(dst, p);
+        }
+        break;
+    case 4:
+        for (; i + 4 <= count; i += 4, dst += 16)
+        {
+            uint32x4x4_t p;
+
+            p.val[0] = p.val[1] = p.val[2] = p.val[3] = lookupNeon(src + i, lut);
+            vst4q_u32(dst, p);
+        }
+        break;
+    }
+    widenLutScalar(dst, src + i, count - i, zoom, lut);
+}
+
+static bool
+hasNeon(void)
+{
+#if defined(__arm__) && defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+    return true;  /* compiled for NEON, and mandatory on AArch64 */
+#endif
+}
+#endif /* UNPACK_NEON */
+
+/*
+ * Pick the best kernels for the CPU
+ */
+static void
+resolve(void)
+{
+    unpack_nibbles = unpackNibblesScalar;
+    unpack_crumbs = unpackCrumbsScalar;
+    unpack_widen = widenScalar;
+    unpack_widenLut = widenLutScalar;
+    unpack_kernels = "scalar";
+
+#ifdef UNPACK_SSE2
+    if (hasSse2())
+    {
+        unpack_nibbles = unpackNibblesSse2;
+        unpack_crumbs = unpackCrumbsSse2;
+        unpack_widen = widenSse2;
+        unpack_widenLut = widenLutSse2;
+        unpack_kernels = "sse2";
+        if (hasSsse3())
+        {
+            unpack_widen = widenSsse3;
+            unpack_kernels = "ssse3";
+        }
+    }
+#endif
+#ifdef UNPACK_NEON
+    if (hasNeon())
+    {
+        unpack_nibbles = unpackNibblesNeon;
+        unpack_crumbs = unpackCrumbsNeon;
+        unpack_widen = widenNeon;
+        unpack_widenLut = widenLutNeon;
+        unpack_kernels = "neon";
+    }
+#endif
+}
+
+static void
+resolveNibbles(U8 *dst, const U32 *src, size_t count)
+{
+    resolve();
+    unpack_nibbles(dst, src, count);
+}
+
+static void
+resolveCrumbs(U8 *dst, const U16 *src, size_t count, U16 filter)
+{
+    resolve();
+    unpack_crumbs(dst, src, count, filter);
+}
+
+static void
+resolveWiden(U8 *dst, const U8 *src, size_t count, U8 zoom)
+{
+    resolve();
+    unpack_widen(dst, src, count, zoom);
+}
+
+static void
+resolveWidenLut(U32 *dst, const U8 *src, size_t count, U8 zoom, const U32 *lut)
+{
+    resolve();
+    unpack_widenLut(dst, src, count, zoom, lut);
+}
+
+/* eof */
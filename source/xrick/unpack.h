@@ -0,0 +1,53 @@
+/*
+ * xrick/unpack.h
+ *
+ * Copyright (C) 1998-2002 BigOrno (bigorno@bigorno.net).
+ * Copyright (C) 2008-2014 Pierluigi Vicinanza.
+ * All rights reserved.
+ *
+ * The use and distribution terms for this software are contained in the file
+ * named README, which can be found in the root of this distribution. By
+ * using this software in any fashion, you are agreeing to be bound by the
+ * terms of this license.
+ *
+ * You must not remove this notice, or any other, from this software.
+ */
+
+#ifndef _UNPACK_H
+#define _UNPACK_H
+
+#include "xrick/system/basic_types.h"
+
+#include <stddef.h> /* size_t */
+
+/*
+ * Unpack packed pixels to 8 bits per pixel
+ *
+ * unpack_nibbles: count words of 8 pixels, 4 bits per pixel (ST)
+ * unpack_crumbs: count words of 8 pixels, 2 bits per pixel (CGA), each
+ *   word being and-ed with a colors filter first
+ *
+ * The leftmost pixel is in the most significant bits of each word.
+ *
+ * unpack_widen: widen count 8 bits pixels, repeating each of them zoom
+ *   times (zoom from 1 to 4, see SYSVID_MAXZOOM), for display upscaling
+ * unpack_widenLut: same, converting pixels to 32 bits through a 256
+ *   entries color lookup table on the way
+ *
+ * These point to the best kernels for the CPU, picked when first called.
+ */
+
+typedef void (*unpack_nibbles_t)(U8 *dst, const U32 *src, size_t count);
+typedef void (*unpack_crumbs_t)(U8 *dst, const U16 *src, size_t count, U16 filter);
+typedef void (*unpack_widen_t)(U8 *dst, const U8 *src, size_t count, U8 zoom);
+typedef void (*unpack_widenLut_t)(U32 *dst, const U8 *src, size_t count, U8 zoom, const U32 *lut);
+
+extern unpack_nibbles_t unpack_nibbles;
+extern unpack_crumbs_t unpack_crumbs;
+extern unpack_widen_t unpack_widen;
+extern unpack_widenLut_t unpack_widenLut;
+extern const char *unpack_kernels;  /* "scalar", "sse2", "ssse3" or "neon" */
+
+#endif /* ndef _UNPACK_H */
+
+/* eof */
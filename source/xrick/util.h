@@ -17,12 +17,13 @@
 #define _UTIL_H
 
 #include "xrick/system/basic_types.h"
+#include "xrick/system/system.h"
 
 extern void u_envtest(S16, S16, bool, U8 *, U8 *);
 extern bool u_boxtest(U8, U8);
 extern bool u_fboxtest(U8, S16, S16);
 extern bool u_trigbox(U8, S16, S16);
-extern char * u_strdup(const char *);
+extern char * u_strdup(const char *, sysmem_tag_t);
 
 #endif /* ndef _UTIL_H */
 